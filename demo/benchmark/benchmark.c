@@ -0,0 +1,527 @@
+/*********************************************************************
+ * Driver Benchmark - Demo Program
+ * Short Name: benchmark
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description:		measures the clock cycles of the driver functions
+ *								with Timer1 and sends min/avg/max as CSV over 
+ *								the UART
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ * [17.10.2026][nmt]: number formatting compared with utoa and snprintf
+ * [17.10.2026][nmt]: system tick, reading the time and the tick ISR
+ * [17.10.2026][nmt]: timer wheel, start/cancel and the tick
+ * [17.10.2026][nmt]: stops after the last row, ends the simulation
+ * [17.10.2026][nmt]: PWM dithering step for 1 to 8 extra bits
+ *********************************************************************/
+
+/*********************************************************************
+ * Usage:
+ *					Flash the program, or run it with "make sim", and read 
+ *					the UART at 9600 baud. After a short pause it prints
+ *
+ *					name,iterations,min,avg,max
+ *
+ *					followed by one line per measured operation, all values 
+ *					in clock cycles. The cost of the measurement itself is 
+ *					already subtracted. Connect the MPU6050 like in the TWI 
+ *					demo for meaningful TWI numbers, without it the TWI rows 
+ *					measure the failure path. Under simavr the numbers are 
+ *					exact, on the hardware the maximum may include the 1 ms 
+ *					tick and UART interrupts. tools/sim_test compares the
+ *					rows with a baseline, see its Makefile.
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <util/delay.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "uart.h"
+#include "uart_fmt.h"
+#include "twi.h"
+#include "frame.h"
+#include "systick.h"
+#include "wheel.h"
+#include "pwm_dither.h"
+
+/* NOTE: only used for "make sim", tells simavr which MCU and clock to
+ * use */
+#ifdef SIMAVR
+#include "avr_mcu_section.h"
+AVR_MCU(F_CPU, "atmega328p");
+#endif
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* measurements per operation */
+#define BENCH_ITERATIONS 100
+
+/* pause before each operation in ms, the UART sends everything that
+ * is still in the ring buffer, so its interrupt does not disturb */
+#define BENCH_SETTLE_DELAY 100
+
+/* 7-bit address of the MPU6050 and the first sample register */
+#define MPU6050_I2C_ADDR 0x68
+#define MPU6050_SAMPLE_REGISTER 0x3b
+#define MPU6050_SAMPLE_SIZE 14
+
+/* Timer2 compare value for a 1 ms tick at prescaler 64 */
+#define TICK_COMPARE_VALUE ((F_CPU / 64UL / 1000UL) - 1)
+
+/* periodic timers in the wheel while it is measured, spread over 
+ * the first two levels */
+#define BENCH_WHEEL_TIMERS 8
+
+/*********************************************************************
+ * TYPES
+ *********************************************************************/
+/* results of one operation */
+struct bench_result {
+	uint16_t min;
+	uint16_t max;
+	uint32_t sum;
+};
+
+/* a measured operation, setup runs before every measurement and is
+ * not counted */
+struct bench_operation {
+	const char *name;
+	void (*setup)(void);
+	void (*op)(void);
+};
+
+/*********************************************************************
+ * FUNCTION PROTOTYPES
+ *********************************************************************/
+/**
+ * @brief measures an operation BENCH_ITERATIONS times
+ * @param operation the operation to measure
+ * @param overhead cycles of an empty measurement to subtract
+ * @param result storage for the result
+ * @return void
+ */
+static void bench_run(const struct bench_operation *operation, uint16_t overhead,
+		struct bench_result *result);
+
+/**
+ * @brief sends a result as a CSV line
+ * @param name name of the operation
+ * @param result the result
+ * @return void
+ */
+static void bench_report(const char *name, const struct bench_result *result);
+
+/* the operations */
+static void op_empty(void);
+static void op_uart_send(void);
+static void op_uart_send_string(void);
+static void op_frame_send(void);
+static void setup_twi_write(void);
+static void op_twi_write(void);
+static void op_twi_read_reg(void);
+static void op_twi_read_sample(void);
+static void setup_int0(void);
+static void op_int0_toggle(void);
+static void op_print_u16(void);
+static void op_utoa_u16(void);
+static void op_snprintf_u16(void);
+static void op_print_u32(void);
+static void op_ultoa_u32(void);
+static void op_print_fixed(void);
+static void op_systick_millis(void);
+static void op_systick_micros(void);
+static void setup_systick_no_isr(void);
+static void setup_systick_isr(void);
+static void op_systick_start(void);
+static void op_wheel_start_cancel(void);
+static void setup_wheel_tick(void);
+static void op_wheel_tick(void);
+static void bench_wheel_callback(uint8_t id);
+static void op_pwm_dither_1(void);
+static void op_pwm_dither_2(void);
+static void op_pwm_dither_3(void);
+static void op_pwm_dither_4(void);
+static void op_pwm_dither_5(void);
+static void op_pwm_dither_6(void);
+static void op_pwm_dither_7(void);
+static void op_pwm_dither_8(void);
+
+/*********************************************************************
+ * VARIABLES
+ *********************************************************************/
+static uint8_t test_string[7] = { 'n', 't', '-', 'c', 'o', 'm', '\n' };
+static uint8_t sample[MPU6050_SAMPLE_SIZE];
+static char number_string[12];
+
+/* volatile, so the compiler can not format the numbers at compile 
+ * time */
+static volatile uint16_t number_u16 = 54321;
+static volatile uint32_t number_u32 = 3000000000UL;
+static volatile int16_t number_q14 = -12345;
+
+/* input and output of the dithering rows, the lower bits of the duty
+ * cycle give a carry in some steps and none in others */
+static volatile uint16_t dither_duty = 0x0aaa;
+static volatile uint8_t dither_ocr = 0;
+static uint8_t dither_sum = 0;
+
+/* everything that is measured, op_empty must stay first, it is used
+ * to measure the cost of the measurement */
+static const struct bench_operation operations[] = {
+	{ "empty", 0, op_empty },
+	{ "uart_send", 0, op_uart_send },
+	{ "uart_send_string_7", 0, op_uart_send_string },
+	{ "frame_send_14", 0, op_frame_send },
+	{ "twi_write", setup_twi_write, op_twi_write },
+	{ "twi_read_regs_1", 0, op_twi_read_reg },
+	{ "twi_read_regs_14", 0, op_twi_read_sample },
+	{ "int0_toggle_no_isr", 0, op_int0_toggle },
+	{ "int0_toggle_timer_isr", setup_int0, op_int0_toggle },
+	{ "uart_print_u16", 0, op_print_u16 },
+	{ "utoa_u16", 0, op_utoa_u16 },
+	{ "snprintf_u16", 0, op_snprintf_u16 },
+	{ "uart_print_u32", 0, op_print_u32 },
+	{ "ultoa_u32", 0, op_ultoa_u32 },
+	{ "uart_print_fixed_q14", 0, op_print_fixed },
+	{ "systick_millis", 0, op_systick_millis },
+	{ "systick_micros", 0, op_systick_micros },
+	{ "wheel_start_cancel", 0, op_wheel_start_cancel },
+	/* the maximum is a tick that sorts a slot of level 1 down */
+	{ "wheel_tick", setup_wheel_tick, op_wheel_tick },
+	/* one step of the PWM dithering per PWM_DITHER_BITS, the overflow 
+	 * ISR of a dithered timer runs two per period */
+	{ "pwm_dither_1", 0, op_pwm_dither_1 },
+	{ "pwm_dither_2", 0, op_pwm_dither_2 },
+	{ "pwm_dither_3", 0, op_pwm_dither_3 },
+	{ "pwm_dither_4", 0, op_pwm_dither_4 },
+	{ "pwm_dither_5", 0, op_pwm_dither_5 },
+	{ "pwm_dither_6", 0, op_pwm_dither_6 },
+	{ "pwm_dither_7", 0, op_pwm_dither_7 },
+	{ "pwm_dither_8", 0, op_pwm_dither_8 },
+	/* these two must stay last, they leave Timer0 running at full 
+	 * clock */
+	{ "systick_start_no_isr", setup_systick_no_isr, op_systick_start },
+	{ "systick_start_tick_isr", setup_systick_isr, op_systick_start }
+};
+
+#define BENCH_OPERATIONS (sizeof(operations) / sizeof(operations[0]))
+
+/*********************************************************************
+ * MAIN FUNCTION
+ *********************************************************************/
+int main(void) {
+
+	struct bench_result result;
+	uint16_t overhead = 0;
+	uint8_t i = 0;
+
+	uart_init();
+	twi_init();
+	systick_init();
+
+	/* the wheel is only ticked by op_wheel_tick */
+	wheel_init();
+	for(i = 0; i < BENCH_WHEEL_TIMERS; i++) {
+		wheel_start(20 + (i * 9), 64, bench_wheel_callback);
+	}
+
+	/* Timer1 counts every clock cycle, normal mode, no interrupts */
+	TCCR1A = 0;
+	TCCR1B = (1 << CS10);
+
+	/* 1 ms tick for the TWI timeouts, CTC mode on Timer2 */
+	TCCR2A = (1 << WGM21);
+	OCR2A = TICK_COMPARE_VALUE;
+	TIMSK2 = (1 << OCIE2A);
+	TCCR2B = (1 << CS22);
+
+	/* pin D2 as an output, writing it triggers INT0 by software */
+	DDRD |= (1 << DDD2);
+	/* pin B1 is toggled by the ISR like in the timer demos */
+	DDRB |= (1 << DDB1);
+
+	sei();
+
+	_delay_ms(BENCH_SETTLE_DELAY);
+	bench_report(0, 0);
+
+	for(i = 0; i < BENCH_OPERATIONS; i++) {
+		bench_run(&operations[i], overhead, &result);
+		if(i == 0) {
+			/* the empty operation is the cost of the measurement */
+			overhead = result.min;
+		}
+		bench_report(operations[i].name, &result);
+	}
+
+	/* let the UART send the last row, then sleep for good. simavr
+	 * ends the simulation on a sleep with interrupts disabled, so
+	 * tools/sim_test does not have to wait for its time limit. */
+	_delay_ms(BENCH_SETTLE_DELAY);
+	cli();
+	set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+	sleep_enable();
+	sleep_cpu();
+
+	while(1) {
+		/* not reached */
+	}
+}
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+static void bench_run(const struct bench_operation *operation, uint16_t overhead,
+		struct bench_result *result) {
+
+	uint8_t i = 0;
+	uint16_t start = 0;
+	uint16_t cycles = 0;
+
+	result->min = 0xffff;
+	result->max = 0;
+	result->sum = 0;
+
+	_delay_ms(BENCH_SETTLE_DELAY);
+
+	for(i = 0; i < BENCH_ITERATIONS; i++) {
+
+		if(operation->setup) {
+			operation->setup();
+		}
+
+		/* NOTE: 16 bit difference, operations must take less than 
+		 * 65536 cycles (4 ms at 16 MHz) */
+		start = TCNT1;
+		operation->op();
+		cycles = TCNT1 - start - overhead;
+
+		if(cycles < result->min) {
+			result->min = cycles;
+		}
+		if(cycles > result->max) {
+			result->max = cycles;
+		}
+		result->sum += cycles;
+
+		/* let the UART send what the operation queued */
+		_delay_ms(10);
+	}
+
+	/* leave INT0 as op_int0_toggle expects it */
+	EIMSK &= ~(1 << INT0);
+}
+
+static void bench_send_text(const char *text) {
+	while(*text) {
+		uart_send(*text++);
+	}
+}
+
+static void bench_report(const char *name, const struct bench_result *result) {
+
+	/* without a result print the header */
+	if(!result) {
+		bench_send_text("name,iterations,min,avg,max\n");
+		return;
+	}
+
+	bench_send_text(name);
+	uart_send(',');
+	uart_print_u32(BENCH_ITERATIONS);
+	uart_send(',');
+	uart_print_u32(result->min);
+	uart_send(',');
+	uart_print_u32(result->sum / BENCH_ITERATIONS);
+	uart_send(',');
+	uart_print_u32(result->max);
+	uart_send('\n');
+}
+
+/* the measured operations */
+
+static void op_empty(void) {
+}
+
+static void op_uart_send(void) {
+	uart_send('.');
+}
+
+static void op_uart_send_string(void) {
+	uart_send_string(&test_string[0], 7);
+}
+
+static void op_frame_send(void) {
+	frame_send(FRAME_TYPE_SAMPLE, 0, &sample[0], MPU6050_SAMPLE_SIZE);
+}
+
+static void setup_twi_write(void) {
+	/* the measurement covers the address byte only */
+	twi_start();
+}
+
+static void op_twi_write(void) {
+	twi_write((MPU6050_I2C_ADDR << 1) | TW_WRITE);
+	twi_stop();
+}
+
+static void op_twi_read_reg(void) {
+	twi_read_regs(MPU6050_I2C_ADDR, MPU6050_SAMPLE_REGISTER, &sample[0], 1);
+}
+
+static void op_twi_read_sample(void) {
+	twi_read_regs(MPU6050_I2C_ADDR, MPU6050_SAMPLE_REGISTER, &sample[0], MPU6050_SAMPLE_SIZE);
+}
+
+static void setup_int0(void) {
+	/* any edge on pin D2 triggers INT0 */
+	EICRA = (1 << ISC00);
+	EIFR = (1 << INTF0);
+	EIMSK |= (1 << INT0);
+}
+
+static void op_int0_toggle(void) {
+	/* writing PIND toggles the pin, the ISR runs right after this if
+	 * INT0 is enabled, the difference between the two int0 rows is the
+	 * cost of the ISR of the timer demos */
+	PIND = (1 << PIND2);
+}
+
+/* the formatting rows all queue the same characters into the UART, 
+ * the difference is the cost of finding the digits */
+static void op_print_u16(void) {
+	uart_print_u16(number_u16);
+}
+
+static void op_utoa_u16(void) {
+	utoa(number_u16, &number_string[0], 10);
+	bench_send_text(&number_string[0]);
+}
+
+static void op_snprintf_u16(void) {
+	snprintf(&number_string[0], sizeof(number_string), "%u", number_u16);
+	bench_send_text(&number_string[0]);
+}
+
+static void op_print_u32(void) {
+	uart_print_u32(number_u32);
+}
+
+static void op_ultoa_u32(void) {
+	ultoa(number_u32, &number_string[0], 10);
+	bench_send_text(&number_string[0]);
+}
+
+static void op_print_fixed(void) {
+	uart_print_fixed(number_q14, 14, 4);
+}
+
+static void op_systick_millis(void) {
+	number_u32 = systick_millis();
+}
+
+static void op_systick_micros(void) {
+	number_u32 = systick_micros();
+}
+
+/* stops Timer0 two counts before the compare match, op_systick_start
+ * runs it at full clock, so the match follows within 2 cycles. The 
+ * difference between the two systick_start rows is the cost of the 
+ * 1 ms tick ISR including entry and exit. */
+static void setup_systick(void) {
+	TCCR0B = 0;
+	TCNT0 = SYSTICK_OCR - 1;
+	TIFR0 = (1 << OCF0A);
+}
+
+static void setup_systick_no_isr(void) {
+	setup_systick();
+	TIMSK0 &= ~(1 << OCIE0A);
+}
+
+static void setup_systick_isr(void) {
+	setup_systick();
+	TIMSK0 |= (1 << OCIE0A);
+}
+
+static void op_systick_start(void) {
+	TCCR0B = (1 << CS00);
+}
+
+static void op_wheel_start_cancel(void) {
+	wheel_cancel(wheel_start(1000, 0, bench_wheel_callback));
+}
+
+/* restarts the timers that expired in the last tick */
+static void setup_wheel_tick(void) {
+	wheel_run();
+}
+
+static void op_wheel_tick(void) {
+	wheel_tick();
+}
+
+static void bench_wheel_callback(uint8_t id) {
+}
+
+/* the bit count is a constant in each row, like PWM_DITHER_BITS in 
+ * pwm.c, so each row measures the code the PWM driver gets */
+static void op_pwm_dither_1(void) {
+	dither_ocr = pwm_dither_step(dither_duty, &dither_sum, 1);
+}
+
+static void op_pwm_dither_2(void) {
+	dither_ocr = pwm_dither_step(dither_duty, &dither_sum, 2);
+}
+
+static void op_pwm_dither_3(void) {
+	dither_ocr = pwm_dither_step(dither_duty, &dither_sum, 3);
+}
+
+static void op_pwm_dither_4(void) {
+	dither_ocr = pwm_dither_step(dither_duty, &dither_sum, 4);
+}
+
+static void op_pwm_dither_5(void) {
+	dither_ocr = pwm_dither_step(dither_duty, &dither_sum, 5);
+}
+
+static void op_pwm_dither_6(void) {
+	dither_ocr = pwm_dither_step(dither_duty, &dither_sum, 6);
+}
+
+static void op_pwm_dither_7(void) {
+	dither_ocr = pwm_dither_step(dither_duty, &dither_sum, 7);
+}
+
+static void op_pwm_dither_8(void) {
+	dither_ocr = pwm_dither_step(dither_duty, &dither_sum, 8);
+}
+
+/*********************************************************************
+ * INTERRUPT SERVICE ROUTINES
+ *********************************************************************/
+/* same body as the ISR of the 16-bit timer demo */
+ISR (INT0_vect) {
+	PINB = 0x02;
+}
+
+/* 1 ms tick */
+ISR (TIMER2_COMPA_vect) {
+	twi_tick();
+}
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
@@ -11,6 +11,7 @@
  * Changelog:
  * [Date][Author]:[Change]
  * [21.09.2019][nmt]: initial commit
+ * [17.10.2026][nmt]: simavr support, see the sim target
  *********************************************************************/
 
 /*********************************************************************
@@ -28,6 +29,18 @@
 #include <avr/interrupt.h>
 #include <util/delay.h>
 
+/* NOTE: only used for "make sim", tells simavr which MCU and clock to
+ * use and which registers to record in ext_int.vcd */
+#ifdef SIMAVR
+#include "avr_mcu_section.h"
+AVR_MCU(F_CPU, "atmega328p");
+AVR_MCU_VCD_FILE("ext_int.vcd", 1000);
+const struct avr_mmcu_vcd_trace_t simavr_trace[] _MMCU_ = {
+	{ AVR_MCU_VCD_SYMBOL("PD6"), .mask = (1 << PD6), .what = (void*)&PORTD, },
+	{ AVR_MCU_VCD_SYMBOL("PD2"), .mask = (1 << PD2), .what = (void*)&PIND, },
+};
+#endif
+
 /*********************************************************************
  * MAIN FUNCTION
  *********************************************************************/ 
@@ -0,0 +1,347 @@
+/*********************************************************************
+ * PWM Driver - C File
+ * Short Name: pwm
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: hardware PWM on the six outputs OC0A/B, OC1A/B and
+ *							OC2A/B, updates are applied together once per period
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ * [17.10.2026][nmt]: the overflow ISR steps the waveform engine
+ * [17.10.2026][nmt]: sigma-delta dithering of Timer0 and Timer2
+ * [17.10.2026][nmt]: fast mode writes both OCR values after BOTTOM
+ * [17.10.2026][nmt]: dithering step moved to pwm_dither.h
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/interrupt.h>
+
+#include "pwm.h"
+#if PWM0_DITHER || PWM2_DITHER
+	#include "pwm_dither.h"
+#endif
+#if PWM_WAVE
+	#include "pwm_wave.h"
+#endif
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* compare output mode of an output, see tables 14-3, 15-3 and 17-3 */
+#define PWM_COM(used, invert, com1, com0) ((used) ? \
+	((1 << (com1)) | ((invert) ? (1 << (com0)) : 0)) : 0)
+
+/* channels in use */
+#define PWM_USED_0A ((PWM0_MODE != PWM_MODE_OFF) && PWM0_OUTPUT_A)
+#define PWM_USED_0B ((PWM0_MODE != PWM_MODE_OFF) && PWM0_OUTPUT_B)
+#define PWM_USED_1A ((PWM1_MODE != PWM_MODE_OFF) && PWM1_OUTPUT_A)
+#define PWM_USED_1B ((PWM1_MODE != PWM_MODE_OFF) && PWM1_OUTPUT_B)
+#define PWM_USED_2A ((PWM2_MODE != PWM_MODE_OFF) && PWM2_OUTPUT_A)
+#define PWM_USED_2B ((PWM2_MODE != PWM_MODE_OFF) && PWM2_OUTPUT_B)
+
+/*********************************************************************
+ * VARIABLES
+ *********************************************************************/
+/* TOP per channel, 0 if the channel is not used */
+static const uint16_t pwm_tops[PWM_CHANNEL_COUNT] = {
+	PWM_USED_0A ? PWM0_DUTY_TOP : 0,
+	PWM_USED_0B ? PWM0_DUTY_TOP : 0,
+	PWM_USED_1A ? PWM1_TOP : 0,
+	PWM_USED_1B ? PWM1_TOP : 0,
+	PWM_USED_2A ? PWM2_DUTY_TOP : 0,
+	PWM_USED_2B ? PWM2_DUTY_TOP : 0
+};
+
+/* written by pwm_set */
+static uint16_t pwm_staged[PWM_CHANNEL_COUNT];
+/* timers with staged changes, bit n for Timer n */
+static uint8_t pwm_changed = 0;
+
+/* handed over by pwm_commit, read by the ISRs */
+static volatile uint16_t pwm_pending[PWM_CHANNEL_COUNT];
+
+#if PWM0_DITHER || PWM2_DITHER
+/* sum of the lower bits of the dithered channels, only used by the
+ * ISRs */
+static uint8_t pwm_dither_sum[PWM_CHANNEL_COUNT];
+#endif
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ *********************************************************************/
+#if PWM0_DITHER || PWM2_DITHER
+/* next OCR value of a dithered channel on Timer0 or Timer2 */
+static inline uint8_t pwm_dither(uint8_t channel) {
+	return pwm_dither_step(pwm_pending[channel], &pwm_dither_sum[channel], PWM_DITHER_BITS);
+}
+#endif
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+void pwm_init(void) {
+
+	uint8_t i = 0;
+
+	for(i = 0; i < PWM_CHANNEL_COUNT; i++) {
+		pwm_staged[i] = 0;
+		pwm_pending[i] = 0;
+#if PWM0_DITHER || PWM2_DITHER
+		pwm_dither_sum[i] = 0;
+#endif
+	}
+	pwm_changed = 0;
+
+	/* halt all timers, they start together at the end */
+	GTCCR = (1 << TSM) | (1 << PSRASY) | (1 << PSRSYNC);
+
+#if PWM0_MODE != PWM_MODE_OFF
+	TCCR0B = 0;
+	TCNT0 = 0;
+	OCR0A = 0;
+	OCR0B = 0;
+	TCCR0A = PWM_COM(PWM0_OUTPUT_A, PWM0_INVERT, COM0A1, COM0A0) |
+		PWM_COM(PWM0_OUTPUT_B, PWM0_INVERT, COM0B1, COM0B0) |
+		/* mode 3 fast, mode 1 phase correct, TOP 0xff */
+		((PWM0_MODE == PWM_MODE_FAST) ? (1 << WGM01) : 0) | (1 << WGM00);
+	TCCR0B = PWM0_CS;
+	#if PWM0_OUTPUT_A
+	DDRD |= (1 << DDD6);
+	#endif
+	#if PWM0_OUTPUT_B
+	DDRD |= (1 << DDD5);
+	#endif
+#endif
+
+#if PWM1_MODE != PWM_MODE_OFF
+	TCCR1B = 0;
+	TCNT1 = 0;
+	ICR1 = PWM1_TOP;
+	OCR1A = 0;
+	OCR1B = 0;
+	/* TOP is ICR1 in all modes: 14 fast, 10 phase correct, 8 phase and
+	 * frequency correct */
+	TCCR1A = PWM_COM(PWM1_OUTPUT_A, PWM1_INVERT, COM1A1, COM1A0) |
+		PWM_COM(PWM1_OUTPUT_B, PWM1_INVERT, COM1B1, COM1B0) |
+		((PWM1_MODE != PWM_MODE_PHASE_FREQ) ? (1 << WGM11) : 0);
+	TCCR1B = (1 << WGM13) | ((PWM1_MODE == PWM_MODE_FAST) ? (1 << WGM12) : 0) |
+		PWM1_CS;
+	#if PWM1_OUTPUT_A
+	DDRB |= (1 << DDB1);
+	#endif
+	#if PWM1_OUTPUT_B
+	DDRB |= (1 << DDB2);
+	#endif
+#endif
+
+#if PWM2_MODE != PWM_MODE_OFF
+	TCCR2B = 0;
+	TCNT2 = 0;
+	OCR2A = 0;
+	OCR2B = 0;
+	TCCR2A = PWM_COM(PWM2_OUTPUT_A, PWM2_INVERT, COM2A1, COM2A0) |
+		PWM_COM(PWM2_OUTPUT_B, PWM2_INVERT, COM2B1, COM2B0) |
+		((PWM2_MODE == PWM_MODE_FAST) ? (1 << WGM21) : 0) | (1 << WGM20);
+	TCCR2B = PWM2_CS;
+	#if PWM2_OUTPUT_A
+	DDRB |= (1 << DDB3);
+	#endif
+	#if PWM2_OUTPUT_B
+	DDRD |= (1 << DDD3);
+	#endif
+#endif
+
+	/* the ISRs of dithered timers run in every period */
+#if PWM0_DITHER && (PWM0_MODE != PWM_MODE_OFF)
+	pwm_overflow_enable(0);
+#endif
+#if PWM2_DITHER && (PWM2_MODE != PWM_MODE_OFF)
+	pwm_overflow_enable(2);
+#endif
+
+	/* release the prescalers, the timers start in the same cycle */
+	GTCCR = 0;
+}
+
+uint8_t pwm_set(uint8_t channel, uint16_t duty) {
+
+	if((channel >= PWM_CHANNEL_COUNT) || (pwm_tops[channel] == 0) ||
+			(duty > pwm_tops[channel])) {
+		return 1;
+	}
+
+	pwm_staged[channel] = duty;
+	/* two channels per timer */
+	pwm_changed |= (1 << (channel >> 1));
+
+	return 0;
+}
+
+void pwm_commit(void) {
+
+	uint8_t sreg = SREG;
+	uint8_t timer = 0;
+
+	/* a commit that was not applied yet is replaced as a whole */
+	cli();
+	for(timer = 0; timer < 3; timer++) {
+		if(pwm_changed & (1 << timer)) {
+			pwm_pending[timer << 1] = pwm_staged[timer << 1];
+			pwm_pending[(timer << 1) + 1] = pwm_staged[(timer << 1) + 1];
+			pwm_overflow_enable(timer);
+		}
+	}
+	pwm_changed = 0;
+	SREG = sreg;
+}
+
+void pwm_write(uint8_t channel, uint16_t duty) {
+	pwm_staged[channel] = duty;
+	pwm_pending[channel] = duty;
+	pwm_overflow_enable(channel >> 1);
+}
+
+void pwm_overflow_enable(uint8_t timer) {
+
+	/* an old flag would call the ISR at once, anywhere in the period */
+	switch(timer) {
+#if PWM0_MODE != PWM_MODE_OFF
+		case 0:
+			if(!(TIMSK0 & (1 << TOIE0))) {
+				TIFR0 = (1 << TOV0);
+				TIMSK0 |= (1 << TOIE0);
+			}
+			break;
+#endif
+#if PWM1_MODE != PWM_MODE_OFF
+		case 1:
+			if(!(TIMSK1 & (1 << TOIE1))) {
+				TIFR1 = (1 << TOV1);
+				TIMSK1 |= (1 << TOIE1);
+			}
+			break;
+#endif
+#if PWM2_MODE != PWM_MODE_OFF
+		case 2:
+			if(!(TIMSK2 & (1 << TOIE2))) {
+				TIFR2 = (1 << TOV2);
+				TIMSK2 |= (1 << TOIE2);
+			}
+			break;
+#endif
+		default:
+			break;
+	}
+}
+
+uint16_t pwm_top(uint8_t channel) {
+
+	if(channel >= PWM_CHANNEL_COUNT) {
+		return 0;
+	}
+
+	return pwm_tops[channel];
+}
+
+/*********************************************************************
+ * INTERRUPT SERVICE ROUTINES
+ *********************************************************************/
+/* NOTE: in fast mode the overflow flag is set at TOP and the buffered
+ * OCR values are taken over at BOTTOM, one timer clock later. The ISR
+ * may run before or after that point, a value written before it 
+ * would apply at once and its partner a period later. So the ISR 
+ * calculates both values first, waits until the counter left TOP and
+ * writes them back to back, both apply at the next BOTTOM. The wait 
+ * is at most one timer clock, with the prescaler of 8 it is usually 
+ * over before the ISR gets there. In the phase correct modes the 
+ * overflow is at BOTTOM, the update point is TOP (phase correct) or 
+ * BOTTOM again (phase and frequency correct), half or almost a whole
+ * period away. The ISR of PWM_WAVE_TIMER stays on while a wave runs,
+ * values of the waves are applied one overflow later. The ISRs of 
+ * dithered timers never turn themselves off. */
+#if PWM0_MODE != PWM_MODE_OFF
+ISR (TIMER0_OVF_vect) {
+
+	uint8_t ocr_a = 0;
+	uint8_t ocr_b = 0;
+
+#if PWM0_DITHER
+	ocr_a = pwm_dither(PWM_0A);
+	ocr_b = pwm_dither(PWM_0B);
+#else
+	ocr_a = (uint8_t)pwm_pending[PWM_0A];
+	ocr_b = (uint8_t)pwm_pending[PWM_0B];
+	TIMSK0 &= ~(1 << TOIE0);
+#endif
+#if PWM0_MODE == PWM_MODE_FAST
+	while(TCNT0 == 0xff) {
+	}
+#endif
+	OCR0A = ocr_a;
+	OCR0B = ocr_b;
+#if PWM_WAVE && (PWM_WAVE_TIMER == 0)
+	if(pwm_wave_step()) {
+		TIMSK0 |= (1 << TOIE0);
+	}
+#endif
+}
+#endif
+
+#if PWM1_MODE != PWM_MODE_OFF
+ISR (TIMER1_OVF_vect) {
+
+	uint16_t ocr_a = pwm_pending[PWM_1A];
+	uint16_t ocr_b = pwm_pending[PWM_1B];
+
+	TIMSK1 &= ~(1 << TOIE1);
+#if PWM1_MODE == PWM_MODE_FAST
+	while(TCNT1 == PWM1_TOP) {
+	}
+#endif
+	OCR1A = ocr_a;
+	OCR1B = ocr_b;
+#if PWM_WAVE && (PWM_WAVE_TIMER == 1)
+	if(pwm_wave_step()) {
+		TIMSK1 |= (1 << TOIE1);
+	}
+#endif
+}
+#endif
+
+#if PWM2_MODE != PWM_MODE_OFF
+ISR (TIMER2_OVF_vect) {
+
+	uint8_t ocr_a = 0;
+	uint8_t ocr_b = 0;
+
+#if PWM2_DITHER
+	ocr_a = pwm_dither(PWM_2A);
+	ocr_b = pwm_dither(PWM_2B);
+#else
+	ocr_a = (uint8_t)pwm_pending[PWM_2A];
+	ocr_b = (uint8_t)pwm_pending[PWM_2B];
+	TIMSK2 &= ~(1 << TOIE2);
+#endif
+#if PWM2_MODE == PWM_MODE_FAST
+	while(TCNT2 == 0xff) {
+	}
+#endif
+	OCR2A = ocr_a;
+	OCR2B = ocr_b;
+#if PWM_WAVE && (PWM_WAVE_TIMER == 2)
+	if(pwm_wave_step()) {
+		TIMSK2 |= (1 << TOIE2);
+	}
+#endif
+}
+#endif
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
@@ -0,0 +1,149 @@
+/*********************************************************************
+ * PWM Driver - Header File
+ * Short Name: pwm
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: hardware PWM on the six outputs OC0A/B, OC1A/B and
+ *							OC2A/B, updates are applied together once per period
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ * [17.10.2026][nmt]: single channel updates for the waveform engine
+ * [17.10.2026][nmt]: high resolution Timer1 and dithering, see 
+ *										pwm_cfg.h
+ * [17.10.2026][nmt]: corrected the update point in fast mode
+ * [17.10.2026][nmt]: dithering cost from the benchmark instead of an
+ *										estimate
+ *********************************************************************/
+
+/*********************************************************************
+ * NOTES:	pwm_set only stores the new duty cycle. pwm_commit hands
+ *				all stored values over at once and enables the overflow
+ *				interrupt of the timers with changes. The ISR calculates
+ *				the values of both channels, writes them to the OCRnx
+ *				registers back to back and turns itself off again, the
+ *				hardware buffers them until the next update point. In
+ *				fast mode the overflow is one timer clock before that
+ *				point (TOP versus BOTTOM), there the ISR first waits
+ *				until the counter left TOP, the values then apply one
+ *				period later. So both channels of a timer change in the
+ *				same period and a 16 bit value is never half written.
+ *				Without changes no PWM interrupt runs.
+ *
+ *				pwm_set(PWM_0A, 10);
+ *				pwm_set(PWM_1A, 500);
+ *				pwm_commit();
+ *
+ *				In fast mode a duty cycle of 0 still gives a pulse of one
+ *				timer clock, phase correct mode goes down to 0 %. The
+ *				duty cycle is in timer counts, TOP is 100 %, see pwm_top.
+ *
+ *				Timer1 takes the carrier frequency, TOP and with it the
+ *				resolution of 10 to 16 bit follow, PWM1_BITS tells how
+ *				many. Timer0 and Timer2 can be dithered to 8 +
+ *				PWM_DITHER_BITS bit, then their overflow ISR runs in every
+ *				period. demo/benchmark measures one step of the dithering
+ *				for every bit count, rows pwm_dither_1 to pwm_dither_8.
+ *				The ISR makes two steps and the entry and exit of an ISR,
+ *				the difference of the two int0_toggle rows. Per timer the
+ *				CPU load is
+ *
+ *				(2 * pwm_dither_n + ISR entry and exit) * PWM frequency
+ *				/ F_CPU
+ *
+ *				The limit is usually the flicker rather than the CPU,
+ *				every extra bit halves the lowest frequency of the
+ *				pattern.
+ *
+ *				Each timer is either used here or by another driver, the
+ *				system tick on Timer0 for example can not be combined with
+ *				PWM0_MODE.
+ *********************************************************************/
+
+#ifndef PWM_H
+#define PWM_H
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/io.h>
+#include <stdint.h>
+
+#include "pwm_cfg.h"
+
+/*********************************************************************
+ * ENUMS
+ *********************************************************************/
+/* the outputs, two per timer */
+enum PWM_CHANNELS {
+	PWM_0A,
+	PWM_0B,
+	PWM_1A,
+	PWM_1B,
+	PWM_2A,
+	PWM_2B,
+	PWM_CHANNEL_COUNT
+};
+
+/*********************************************************************
+ * FUNCTION PROTOTYPES
+ *********************************************************************/
+
+/**
+ * @brief sets up the timers, pins and outputs of pwm_cfg.h with a
+ * duty cycle of 0 and starts the timers in phase
+ * NOTE: pwm_commit needs global interrupts
+ * @return void
+ */
+void pwm_init(void);
+
+/**
+ * @brief stores a duty cycle, it is applied by pwm_commit
+ * @param channel one of PWM_CHANNELS
+ * @param duty duty cycle in timer counts [0 - pwm_top(channel)]
+ * @return 0 on success, 1 if the output is not used or the duty cycle
+ * is above TOP
+ */
+uint8_t pwm_set(uint8_t channel, uint16_t duty);
+
+/**
+ * @brief applies all stored duty cycles at the next overflow of their
+ * timers
+ * @return void
+ */
+void pwm_commit(void);
+
+/**
+ * @brief TOP of the timer of a channel, the duty cycle for 100 %
+ * @param channel one of PWM_CHANNELS
+ * @return TOP or 0 if the timer is not used
+ */
+uint16_t pwm_top(uint8_t channel);
+
+/**
+ * @brief applies one duty cycle at the next overflow of its timer, 
+ * for ISRs like pwm_wave_step, the value is also stored for the next
+ * pwm_commit
+ * NOTE: interrupts have to be disabled, there is no range check
+ * @param channel one of PWM_CHANNELS
+ * @param duty duty cycle in timer counts
+ * @return void
+ */
+void pwm_write(uint8_t channel, uint16_t duty);
+
+/**
+ * @brief enables the overflow interrupt of a timer, the ISR runs at 
+ * the next overflow
+ * NOTE: interrupts have to be disabled
+ * @param timer 0, 1 or 2
+ * @return void
+ */
+void pwm_overflow_enable(uint8_t timer);
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
+#endif
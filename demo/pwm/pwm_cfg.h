@@ -0,0 +1,182 @@
+/*********************************************************************
+ * PWM Driver - Configuration File
+ * Short Name: pwm_cfg
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: Settings for the PWM outputs of Timer0, Timer1 and
+ *							Timer2, modes, prescalers and TOP of Timer1
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ * [17.10.2026][nmt]: clock of the waveform engine
+ * [17.10.2026][nmt]: Timer1 solver for the carrier frequency, 
+ *										dithering of the 8 bit timers
+ *********************************************************************/
+
+#ifndef PWM_CFG_H
+#define PWM_CFG_H
+
+/* set CPU frequency for the PWM frequency */
+#ifndef F_CPU
+	#warning "PWM_CFG: F_CPU was undefined setting to 16 MHz"
+	#define F_CPU 16000000UL
+#endif
+
+/* modes of the timers */
+#define PWM_MODE_OFF 0						/* not touched by pwm_init */
+#define PWM_MODE_FAST 1						/* counts up, single slope */
+#define PWM_MODE_PHASE_CORRECT 2	/* counts up and down, dual slope */
+#define PWM_MODE_PHASE_FREQ 3			/* dual slope, TOP is only changed
+																	 * at BOTTOM, Timer1 only */
+
+/*********************************************************************
+ * SETTINGS
+ *********************************************************************/
+/* NOTE: Timer0 and Timer2 count up to 255. Timer1 counts up to
+ * PWM1_TOP in ICR1 in all modes, this sets the resolution from 2 to
+ * 16 bit. The frequency of the PWM is, see sections 14.7, 15.9 and
+ * 17.7 of the ATmega328p datasheet:
+ * fast:						F_CPU / (prescaler * (TOP + 1))
+ * phase correct:		F_CPU / (2 * prescaler * TOP)
+ * Timer1 can also take the frequency, then the solver picks the
+ * smallest prescaler and the largest TOP for it, so the resolution
+ * is as high as possible. Timers with the same mode, prescaler and
+ * TOP stay in phase,
+ * pwm_init starts all of them in the same clock cycle. An output is
+ * used if its PWMn_OUTPUT_x is 1, the pin is set to output.
+ * PWMn_INVERT 1 makes the outputs of a timer active low. */
+
+/* Timer0, 8 bit, OC0A on pin D6, OC0B on pin D5 */
+#define PWM0_MODE PWM_MODE_FAST
+#define PWM0_PRESCALER 8
+#define PWM0_OUTPUT_A 1
+#define PWM0_OUTPUT_B 1
+#define PWM0_INVERT 0
+#define PWM0_DITHER 0
+
+/* Timer1, 16 bit, OC1A on pin B1, OC1B on pin B2, the carrier 
+ * frequency in Hz, the build fails below 10 bit. Remove it and set
+ * PWM1_PRESCALER and PWM1_TOP to choose them directly. At 16 MHz 
+ * 2 kHz phase correct are about 12 bit. */
+#define PWM1_MODE PWM_MODE_PHASE_FREQ
+#define PWM1_FREQUENCY 2000UL
+/* #define PWM1_PRESCALER 1 */
+/* #define PWM1_TOP 1023U */
+#define PWM1_OUTPUT_A 1
+#define PWM1_OUTPUT_B 1
+#define PWM1_INVERT 0
+
+/* Timer2, 8 bit, OC2A on pin B3, OC2B on pin D3 */
+#define PWM2_MODE PWM_MODE_PHASE_CORRECT
+#define PWM2_PRESCALER 8
+#define PWM2_OUTPUT_A 1
+#define PWM2_OUTPUT_B 1
+#define PWM2_INVERT 0
+#define PWM2_DITHER 1
+
+/* NOTE: PWMn_DITHER 1 adds PWM_DITHER_BITS below the 8 bit of Timer0
+ * or Timer2, the duty cycle goes up to 255 << PWM_DITHER_BITS. The 
+ * overflow ISR of the timer runs in every period and adds the lower 
+ * bits to an accumulator, when it overflows the output is one count 
+ * longer for one period, first order sigma-delta. The pattern repeats
+ * at the latest after 2^PWM_DITHER_BITS periods, keep the PWM 
+ * frequency / 2^PWM_DITHER_BITS above 100 Hz against flicker. */
+#define PWM_DITHER_BITS 4
+
+/* waveform engine, see pwm_wave.h, 1 to step the waves in the 
+ * overflow ISR of Timer PWM_WAVE_TIMER, the build needs pwm_wave.c 
+ * then. The overflow rate of that timer is the step rate before the
+ * divider of a wave. */
+#define PWM_WAVE 1
+#define PWM_WAVE_TIMER 0
+
+/*********************************************************************
+ * DERIVED VALUES
+ *********************************************************************/
+/* TOP of the timers */
+#define PWM0_TOP 255U
+#define PWM2_TOP 255U
+
+/* Timer1 solver, TOP at a prescaler for PWM1_FREQUENCY */
+#ifdef PWM1_FREQUENCY
+	#define PWM1_TOP_AT(ps) ((PWM1_MODE == PWM_MODE_FAST) ? \
+		((F_CPU / ((ps) * PWM1_FREQUENCY)) - 1) : (F_CPU / (2UL * (ps) * PWM1_FREQUENCY)))
+	#define PWM1_PRESCALER ((PWM1_TOP_AT(1UL) <= 65535UL) ? 1UL : \
+													(PWM1_TOP_AT(8UL) <= 65535UL) ? 8UL : \
+													(PWM1_TOP_AT(64UL) <= 65535UL) ? 64UL : \
+													(PWM1_TOP_AT(256UL) <= 65535UL) ? 256UL : 1024UL)
+	#define PWM1_TOP PWM1_TOP_AT(PWM1_PRESCALER)
+#endif
+
+/* resolution of Timer1 in full bits */
+#define PWM1_BITS ((PWM1_TOP >= 65535UL) ? 16 : (PWM1_TOP >= 32767UL) ? 15 : \
+									 (PWM1_TOP >= 16383UL) ? 14 : (PWM1_TOP >= 8191UL) ? 13 : \
+									 (PWM1_TOP >= 4095UL) ? 12 : (PWM1_TOP >= 2047UL) ? 11 : \
+									 (PWM1_TOP >= 1023UL) ? 10 : (PWM1_TOP >= 511UL) ? 9 : 8)
+
+/* largest duty cycle of the 8 bit timers, with dithering */
+#define PWM_DITHER_MASK ((1U << PWM_DITHER_BITS) - 1)
+#define PWM0_DUTY_TOP (PWM0_DITHER ? (255U << PWM_DITHER_BITS) : 255U)
+#define PWM2_DUTY_TOP (PWM2_DITHER ? (255U << PWM_DITHER_BITS) : 255U)
+
+/* clock select bits CSn2:0, Timer0 and Timer1 */
+#define PWM_CS01(ps) (((ps) == 1) ? 1 : ((ps) == 8) ? 2 : ((ps) == 64) ? 3 : \
+											((ps) == 256) ? 4 : ((ps) == 1024) ? 5 : 0)
+/* Timer2 has 32 and 128 in addition */
+#define PWM_CS2(ps) (((ps) == 1) ? 1 : ((ps) == 8) ? 2 : ((ps) == 32) ? 3 : \
+										 ((ps) == 64) ? 4 : ((ps) == 128) ? 5 : ((ps) == 256) ? 6 : \
+										 ((ps) == 1024) ? 7 : 0)
+
+#define PWM0_CS PWM_CS01(PWM0_PRESCALER)
+#define PWM1_CS PWM_CS01(PWM1_PRESCALER)
+#define PWM2_CS PWM_CS2(PWM2_PRESCALER)
+
+/* checks, only for timers in use */
+#if PWM0_MODE != PWM_MODE_OFF
+	#if PWM0_CS == 0
+		#error "PWM_CFG: PWM0_PRESCALER must be 1, 8, 64, 256 or 1024"
+	#endif
+	#if PWM0_MODE == PWM_MODE_PHASE_FREQ
+		#error "PWM_CFG: phase and frequency correct mode is Timer1 only"
+	#endif
+#endif
+#if PWM1_MODE != PWM_MODE_OFF
+	#if PWM1_CS == 0
+		#error "PWM_CFG: PWM1_PRESCALER must be 1, 8, 64, 256 or 1024"
+	#endif
+	#if (PWM1_TOP < 3) || (PWM1_TOP > 65535)
+		#error "PWM_CFG: PWM1_TOP must be in [3 - 65535], or PWM1_FREQUENCY is too low"
+	#endif
+	#if defined(PWM1_FREQUENCY) && (PWM1_BITS < 10)
+		#error "PWM_CFG: PWM1_FREQUENCY is too high for 10 bit at this F_CPU"
+	#endif
+#endif
+#if PWM0_DITHER || PWM2_DITHER
+	#if (PWM_DITHER_BITS < 1) || (PWM_DITHER_BITS > 8)
+		#error "PWM_CFG: PWM_DITHER_BITS must be in [1 - 8]"
+	#endif
+#endif
+#if PWM2_MODE != PWM_MODE_OFF
+	#if PWM2_CS == 0
+		#error "PWM_CFG: PWM2_PRESCALER must be 1, 8, 32, 64, 128, 256 or 1024"
+	#endif
+	#if PWM2_MODE == PWM_MODE_PHASE_FREQ
+		#error "PWM_CFG: phase and frequency correct mode is Timer1 only"
+	#endif
+#endif
+#if PWM_WAVE
+	#if (PWM_WAVE_TIMER == 0) && (PWM0_MODE == PWM_MODE_OFF)
+		#error "PWM_CFG: the waveform engine needs a running PWM_WAVE_TIMER"
+	#elif (PWM_WAVE_TIMER == 1) && (PWM1_MODE == PWM_MODE_OFF)
+		#error "PWM_CFG: the waveform engine needs a running PWM_WAVE_TIMER"
+	#elif (PWM_WAVE_TIMER == 2) && (PWM2_MODE == PWM_MODE_OFF)
+		#error "PWM_CFG: the waveform engine needs a running PWM_WAVE_TIMER"
+	#elif PWM_WAVE_TIMER > 2
+		#error "PWM_CFG: PWM_WAVE_TIMER must be 0, 1 or 2"
+	#endif
+#endif
+
+#endif
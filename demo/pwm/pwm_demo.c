@@ -11,13 +11,22 @@
  * Changelog:
  * [Date][Author]:[Change]
  * [20.09.2019][nmt]: initial commit
+ * [17.10.2026][nmt]: simavr support, see the sim target
+ * [17.10.2026][nmt]: all six outputs through the PWM driver
+ * [17.10.2026][nmt]: fades run in the background, the CPU sleeps
+ * [17.10.2026][nmt]: Timer1 at 2 kHz and 12 bit, Timer2 dithered
  *********************************************************************/
 
 /*********************************************************************
  * Usage: 
  *
- * Connect a LED to pin D6 on the arduino, that way you can see 
- * the PWM at work.
+ * Connect LEDs to the pins D6, D5 (Timer0), B1, B2 (Timer1), B3 and
+ * D3 (Timer2) on the arduino, that way you can see the PWM at work.
+ * The LEDs fade in and out with a gamma corrected ramp, each at its 
+ * own speed, the LED on D3 follows a sine. The waveform engine steps 
+ * the fades in the overflow ISR of Timer0, the CPU sleeps in between.
+ * Timer1 runs at 2 kHz with about 12 bit, the outputs of Timer2 are 
+ * dithered from 8 to 12 bit. The modes are set in pwm_cfg.h.
  *********************************************************************/
 
 /*********************************************************************
@@ -25,7 +34,10 @@
  *********************************************************************/
 #include <avr/io.h> 
 #include <avr/interrupt.h>
-#include <util/delay.h>
+#include <avr/sleep.h>
+
+#include "pwm.h"
+#include "pwm_wave.h"
 
 /*********************************************************************
  * MACROS
@@ -35,100 +47,88 @@
 	#define F_CPU 4000000UL
 #endif
 
-#define DUTY_CYCLE_MAX			255
-#define INITIAL_DUTY_CYCLE	128
+/* NOTE: only used for "make sim", tells simavr which MCU and clock to
+ * use and which registers to record in pwm.vcd */
+#ifdef SIMAVR
+#include "avr_mcu_section.h"
+AVR_MCU(F_CPU, "atmega328p");
+AVR_MCU_VCD_FILE("pwm.vcd", 1000);
+const struct avr_mmcu_vcd_trace_t simavr_trace[] _MMCU_ = {
+	{ AVR_MCU_VCD_SYMBOL("OCR0A"), .mask = 0xff, .what = (void*)&OCR0A, },
+	{ AVR_MCU_VCD_SYMBOL("TCNT0"), .mask = 0xff, .what = (void*)&TCNT0, },
+	{ AVR_MCU_VCD_SYMBOL("OCR0B"), .mask = 0xff, .what = (void*)&OCR0B, },
+	{ AVR_MCU_VCD_SYMBOL("OCR2A"), .mask = 0xff, .what = (void*)&OCR2A, },
+	{ AVR_MCU_VCD_SYMBOL("OCR2B"), .mask = 0xff, .what = (void*)&OCR2B, },
+};
+#endif
+
+/* overflows of Timer0 per entry of the fade of channel 0, the next
+ * channels are a bit slower, 7812 overflows per second */
+#define FADE_DIVIDER 20
+#define FADE_DIVIDER_STEP 6
+
+/* overflows per entry of the sine, 64 entries, about 1.6 s */
+#define SINE_DIVIDER 200
 
 /*********************************************************************
- * FUNCTION PROTOTYPES
+ * VARIABLES
  *********************************************************************/ 
-/**
- * @brief sets up the pin B1 to connect an LED
- * @return void
- */
-void gpio_setup(void);
-
-/**
- * @brief sets up the timer
- * @param initial_duty_cycle the initial duty cycle value [0-255]
- * @return void
- */
-void pwm_setup(uint8_t initial_duty_cycle);
+/* channels that are fading out, bit n for channel n */
+static volatile uint8_t fading_out = 0;
 
+/*********************************************************************
+ * FUNCTION PROTOTYPES
+ *********************************************************************/ 
 /**
- * @brief sets the PWM duty cycle
- * @param duty_cycle the duty cycle value [0-255]
+ * @brief called by the waveform engine at the end of a fade, starts
+ * the fade in the other direction
+ * @param channel the channel of the fade
  * @return void
  */
-void pwm_set_duty_cycle(uint8_t duty_cycle);
+void fade_done(uint8_t channel);
 
 /*********************************************************************
  * MAIN FUNCTION
  *********************************************************************/ 
 int main(void) {
 
-	uint8_t ui8_loop = 0x00;
+	uint8_t channel = 0;
 
 	/* initialize peripherals */
 
-	/* the OCR0A register for PWM is at the package pin D6 for the arduino,
-		 this pin outputs the PWM */
-	gpio_setup();
+	/* sets the output pins and starts the three timers in phase */
+	pwm_init();
 
-	pwm_setup(INITIAL_DUTY_CYCLE);
+	/* one fade per channel, the callback keeps them going */
+	for(channel = PWM_0A; channel < PWM_2B; channel++) {
+		pwm_wave_start(channel, pwm_wave_gamma, PWM_WAVE_GAMMA_LENGTH,
+				FADE_DIVIDER + (channel * FADE_DIVIDER_STEP), PWM_WAVE_ONCE, fade_done);
+	}
+	pwm_wave_start(PWM_2B, pwm_wave_sine, PWM_WAVE_SINE_LENGTH, SINE_DIVIDER,
+			PWM_WAVE_LOOP, 0);
 
-	/* global interrupt enable */
+	/* global interrupt enable, the waves are stepped in the overflow 
+		 ISR of Timer0 */
   sei();        
 
+	set_sleep_mode(SLEEP_MODE_IDLE);
+
     while (1) {
 			/* SUPERLOOP */
-	
-			/* we are going to manipulate the duty cycle every 5 ms
-				 the LED will become brighter until the maximum value is 
-				 reached, after that it will turn off briefly starting to
-				 get brighter again */
-			for(ui8_loop = 0; ui8_loop < DUTY_CYCLE_MAX; ui8_loop++) {
-				pwm_set_duty_cycle(ui8_loop);
-				_delay_ms(5);
-			}
 
+			/* nothing to do, the timers keep running in idle mode */
+			sleep_mode();
     }
 }
 
 /*********************************************************************
  * FUNCTIONS
  *********************************************************************/ 
-void gpio_setup() {
-
-	/* gpio setup */
-
-	/* pin D6 to output */
-	DDRD = (1 << DDD6);
-
-}
-
-void pwm_setup(uint8_t duty_cycle) {
+void fade_done(uint8_t channel) {
 
-	/* pwm setup */
-
-	/* NOTE:
-		 We are setting up fast PWM mode below. */
-
-	/* set the initial duty cycle value */
-	OCR0A = duty_cycle;
-
-	/* here we can set what happens to OC0A on a compare match
-		 we will clear the register, corresponding to non-inverting mode */
-	TCCR0A |= (1 << COM0A1); 
-	/* this activates fast PWM, according to table 14-8 in the 
-		 ATmega328p datasheet */
-	TCCR0A |= (1 << WGM00 | (1 << WGM01)); 
-	/* this sets the prescale factor to 8 */
-	TCCR0B |= (1 << CS01);
-	
+	/* same table, the other direction */
+	fading_out ^= (1 << channel);
+	pwm_wave_start(channel, pwm_wave_gamma, PWM_WAVE_GAMMA_LENGTH,
+			FADE_DIVIDER + (channel * FADE_DIVIDER_STEP),
+			(fading_out & (1 << channel)) ? PWM_WAVE_REVERSE : PWM_WAVE_ONCE, fade_done);
 }
-
-void pwm_set_duty_cycle(uint8_t duty_cycle) {
-	OCR0A = duty_cycle;
-}
-
-
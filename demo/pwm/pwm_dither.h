@@ -0,0 +1,67 @@
+/*********************************************************************
+ * PWM Dithering - Header File
+ * Short Name: pwm_dither
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: one step of the sigma-delta modulator that dithers the
+ *							8 bit PWM of Timer0 and Timer2
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit, moved out of pwm.c for the
+ *										benchmark
+ *********************************************************************/
+
+/*********************************************************************
+ * NOTES:	The step is inline and takes the number of extra bits as a
+ *				parameter. With a constant, as in pwm.c, the compiler
+ *				folds the shift and the mask, so the step costs the same
+ *				as a version written for a fixed PWM_DITHER_BITS. This
+ *				lets demo/benchmark measure every bit count in one
+ *				program, see the pwm_dither_n rows.
+ *********************************************************************/
+
+#ifndef PWM_DITHER_H
+#define PWM_DITHER_H
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <stdint.h>
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+
+/**
+ * @brief next OCR value of a dithered channel, one step of the
+ * sigma-delta modulator
+ * @param duty duty cycle with bits extra bits [0 - 255 << bits]
+ * @param sum sum of the lower bits of the channel, kept between steps
+ * @param bits extra bits [1 - 8], should be a constant
+ * @return OCR value for the next period
+ */
+static inline uint8_t pwm_dither_step(uint16_t duty, uint8_t *sum, uint8_t bits) {
+
+	uint8_t mask = (uint8_t)((1U << bits) - 1);
+	/* 16 bit, the sum reaches 2 * 255 at 8 extra bits */
+	uint16_t next = *sum + (duty & mask);
+	uint8_t ocr = (uint8_t)(duty >> bits);
+
+	/* carry, this period is one count longer, ocr is below 255 here
+	 * because 255 has no lower bits */
+	if(next > mask) {
+		ocr++;
+		next -= (uint16_t)mask + 1;
+	}
+	*sum = (uint8_t)next;
+
+	return ocr;
+}
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
+#endif
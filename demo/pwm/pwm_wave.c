@@ -0,0 +1,178 @@
+/*********************************************************************
+ * PWM Waveform Engine - C File
+ * Short Name: pwm_wave
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: plays tables of duty cycles on the PWM outputs from
+ *							the overflow interrupt, fades run in the background
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/interrupt.h>
+
+#include "pwm_wave.h"
+
+/*********************************************************************
+ * TYPES
+ *********************************************************************/
+/* a running wave */
+struct pwm_wave_state {
+	const uint8_t *table;
+	uint16_t length;
+	uint16_t index;
+	uint16_t divider;
+	uint16_t count;
+	uint16_t top;
+	uint8_t mode;
+	pwm_wave_callback_t done;
+};
+
+/*********************************************************************
+ * VARIABLES
+ *********************************************************************/
+/* round(255 * (i / 255)^2.2) */
+const uint8_t pwm_wave_gamma[PWM_WAVE_GAMMA_LENGTH] PROGMEM = {
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+	  1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+	  3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+	  6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+	 12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+	 20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+	 30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+	 42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+	 56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+	 73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+	 91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+	113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+	137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+	163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+	192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+	223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255
+};
+
+/* round(127.5 - 127.5 * cos(2 * pi * i / 64)) */
+const uint8_t pwm_wave_sine[PWM_WAVE_SINE_LENGTH] PROGMEM = {
+	  0,   1,   2,   5,  10,  15,  21,  29,  37,  47,  57,  67,  79,  90, 103, 115,
+	127, 140, 152, 165, 176, 188, 198, 208, 218, 226, 234, 240, 245, 250, 253, 254,
+	255, 254, 253, 250, 245, 240, 234, 226, 218, 208, 198, 188, 176, 165, 152, 140,
+	128, 115, 103,  90,  79,  67,  57,  47,  37,  29,  21,  15,  10,   5,   2,   1
+};
+
+static struct pwm_wave_state waves[PWM_CHANNEL_COUNT];
+
+/* channels with a running wave, bit n for channel n */
+static volatile uint8_t wave_running = 0;
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+uint8_t pwm_wave_start(uint8_t channel, const uint8_t *table, uint16_t length,
+		uint16_t divider, uint8_t mode, pwm_wave_callback_t done) {
+
+	uint8_t sreg = SREG;
+	struct pwm_wave_state *wave = 0;
+
+	if((pwm_top(channel) == 0) || (table == 0) || (length == 0) ||
+			(divider == 0) || (mode > PWM_WAVE_LOOP)) {
+		return 1;
+	}
+
+	wave = &waves[channel];
+
+	cli();
+	wave->table = table;
+	wave->length = length;
+	wave->index = 0;
+	wave->divider = divider;
+	/* the first entry at the next overflow */
+	wave->count = divider - 1;
+	wave->top = pwm_top(channel);
+	wave->mode = mode;
+	wave->done = done;
+	wave_running |= (1 << channel);
+	pwm_overflow_enable(PWM_WAVE_TIMER);
+	SREG = sreg;
+
+	return 0;
+}
+
+void pwm_wave_stop(uint8_t channel) {
+
+	uint8_t sreg = SREG;
+
+	if(channel >= PWM_CHANNEL_COUNT) {
+		return;
+	}
+
+	/* the ISR turns itself off when no wave is left */
+	cli();
+	wave_running &= ~(1 << channel);
+	SREG = sreg;
+}
+
+uint8_t pwm_wave_busy(uint8_t channel) {
+
+	if(channel >= PWM_CHANNEL_COUNT) {
+		return 0;
+	}
+
+	return (wave_running & (1 << channel)) ? 1 : 0;
+}
+
+uint8_t pwm_wave_step(void) {
+
+	uint8_t channel = 0;
+	uint8_t value = 0;
+	uint16_t duty = 0;
+	struct pwm_wave_state *wave = 0;
+
+	for(channel = 0; channel < PWM_CHANNEL_COUNT; channel++) {
+
+		if(!(wave_running & (1 << channel))) {
+			continue;
+		}
+		wave = &waves[channel];
+		if(++wave->count < wave->divider) {
+			continue;
+		}
+		wave->count = 0;
+
+		if(wave->mode == PWM_WAVE_REVERSE) {
+			value = pgm_read_byte(wave->table + (wave->length - 1 - wave->index));
+		} else {
+			value = pgm_read_byte(wave->table + wave->index);
+		}
+		/* 0 - 255 to 0 - TOP, v + (v >> 7) maps 255 to 256, so 100 %
+		 * stays 100 % without a division */
+		if(wave->top == 255) {
+			duty = value;
+		} else {
+			duty = (uint16_t)(((uint32_t)(value + (value >> 7)) * wave->top) >> 8);
+		}
+		pwm_write(channel, duty);
+
+		if(++wave->index >= wave->length) {
+			wave->index = 0;
+			if(wave->mode != PWM_WAVE_LOOP) {
+				wave_running &= ~(1 << channel);
+				if(wave->done) {
+					wave->done(channel);
+				}
+			}
+		}
+	}
+
+	return wave_running ? 1 : 0;
+}
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
@@ -0,0 +1,122 @@
+/*********************************************************************
+ * PWM Waveform Engine - Header File
+ * Short Name: pwm_wave
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: plays tables of duty cycles on the PWM outputs from
+ *							the overflow interrupt, fades run in the background
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * NOTES:	A wave is a table of 8 bit duty cycles in PROGMEM, 255 is
+ *				100 %. The overflow ISR of PWM_WAVE_TIMER, see pwm_cfg.h,
+ *				moves every running channel one entry further every
+ *				divider overflows and hands the value to the driver, so it
+ *				is applied like a pwm_commit. Values are scaled to TOP,
+ *				on Timer1 with a multiplication.
+ *
+ *				pwm_wave_start(PWM_0A, pwm_wave_gamma, PWM_WAVE_GAMMA_LENGTH,
+ *											 30, PWM_WAVE_ONCE, faded_in);
+ *
+ *				fades OC0A in within 256 * 30 overflows, about 1 s at
+ *				7.8 kHz. With PWM_WAVE_REVERSE the same table fades out.
+ *				The callback runs in the ISR when a wave ends, it may start
+ *				the next wave of a sequence, but should not do more.
+ *
+ *				The ISR only runs while a wave or a commit is pending. A
+ *				channel waiting for its divider costs about 12 cycles per
+ *				overflow, a step about 40, on Timer1 about 70. Six fading
+ *				channels at 7.8 kHz take around 6 % of the CPU, a larger
+ *				PWM prescaler lowers the overflow rate and the cost.
+ *********************************************************************/
+
+#ifndef PWM_WAVE_H
+#define PWM_WAVE_H
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/pgmspace.h>
+#include <stdint.h>
+
+#include "pwm.h"
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* how a wave is played */
+#define PWM_WAVE_ONCE 0			/* first to last entry, then stop */
+#define PWM_WAVE_REVERSE 1	/* last to first entry, then stop */
+#define PWM_WAVE_LOOP 2			/* first to last entry, over and over */
+
+/* lengths of the tables below */
+#define PWM_WAVE_GAMMA_LENGTH 256
+#define PWM_WAVE_SINE_LENGTH 64
+
+/*********************************************************************
+ * TYPES
+ *********************************************************************/
+/* called from the ISR with the channel of the wave that ended */
+typedef void (*pwm_wave_callback_t)(uint8_t channel);
+
+/*********************************************************************
+ * TABLES
+ *********************************************************************/
+/* ramp from 0 to 255 with a gamma of 2.2, looks linear to the eye */
+extern const uint8_t pwm_wave_gamma[PWM_WAVE_GAMMA_LENGTH] PROGMEM;
+
+/* one period of a sine, starting and ending at 0 */
+extern const uint8_t pwm_wave_sine[PWM_WAVE_SINE_LENGTH] PROGMEM;
+
+/*********************************************************************
+ * FUNCTION PROTOTYPES
+ *********************************************************************/
+
+/**
+ * @brief starts a wave on a channel, a running wave is replaced
+ * NOTE: the first entry is applied at the next overflow of
+ * PWM_WAVE_TIMER, needs pwm_init and global interrupts
+ * @param channel one of PWM_CHANNELS
+ * @param table duty cycles in PROGMEM, 255 is 100 %
+ * @param length number of entries, at least 1
+ * @param divider overflows per entry, at least 1
+ * @param mode PWM_WAVE_ONCE, PWM_WAVE_REVERSE or PWM_WAVE_LOOP
+ * @param done called when the wave ends, may be 0
+ * @return 0 on success, 1 if the channel is not used or an argument
+ * is out of range
+ */
+uint8_t pwm_wave_start(uint8_t channel, const uint8_t *table, uint16_t length,
+		uint16_t divider, uint8_t mode, pwm_wave_callback_t done);
+
+/**
+ * @brief stops the wave of a channel, the duty cycle stays, the
+ * callback is not called
+ * @param channel one of PWM_CHANNELS
+ * @return void
+ */
+void pwm_wave_stop(uint8_t channel);
+
+/**
+ * @brief checks if a wave is running
+ * @param channel one of PWM_CHANNELS
+ * @return 1 if a wave is running, else 0
+ */
+uint8_t pwm_wave_busy(uint8_t channel);
+
+/**
+ * @brief steps all waves, called by the overflow ISR of
+ * PWM_WAVE_TIMER in pwm.c
+ * @return 1 while a wave is running, else 0
+ */
+uint8_t pwm_wave_step(void);
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
+#endif
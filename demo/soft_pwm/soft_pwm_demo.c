@@ -0,0 +1,102 @@
+/*********************************************************************
+ * Software PWM - Demo Program
+ * Short Name: soft_pwm
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description:		dims 18 LEDs on arbitrary pins with the software PWM
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * Usage:
+ *
+ * Connect LEDs to the pins B0-B5, C0-C5 and D2-D7 on the arduino, the
+ * order of the channels is set in softpwm_cfg.h. A bright spot with a
+ * fading tail runs along the LEDs and back. The PWM runs at 245 Hz
+ * from the Timer2 interrupt, the main loop only computes the next
+ * picture every STEP_DELAY ms and commits it, it is applied at the
+ * start of the next period.
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+
+#include "softpwm.h"
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* set the CPU frequency to 16 MHz */
+#ifndef F_CPU
+	#define F_CPU 16000000UL
+#endif
+
+/* NOTE: only used for "make sim", tells simavr which MCU and clock to
+ * use and which registers to record in soft_pwm.vcd */
+#ifdef SIMAVR
+#include "avr_mcu_section.h"
+AVR_MCU(F_CPU, "atmega328p");
+AVR_MCU_VCD_FILE("soft_pwm.vcd", 1000);
+const struct avr_mmcu_vcd_trace_t simavr_trace[] _MMCU_ = {
+	{ AVR_MCU_VCD_SYMBOL("PORTB"), .mask = 0x3f, .what = (void*)&PORTB, },
+	{ AVR_MCU_VCD_SYMBOL("PORTC"), .mask = 0x3f, .what = (void*)&PORTC, },
+	{ AVR_MCU_VCD_SYMBOL("PORTD"), .mask = 0xfc, .what = (void*)&PORTD, },
+	{ AVR_MCU_VCD_SYMBOL("OCR2A"), .mask = 0xff, .what = (void*)&OCR2A, },
+};
+#endif
+
+/* time between two positions of the spot in ms */
+#define STEP_DELAY 40
+
+/* brightness of the spot and its tail, each one a quarter of the one
+ * before, roughly even steps for the eye */
+#define TAIL_LENGTH 5
+static const uint8_t tail[TAIL_LENGTH] = { SOFTPWM_STEPS, 64, 16, 4, 1 };
+
+/*********************************************************************
+ * MAIN FUNCTION
+ *********************************************************************/
+int main(void) {
+
+	uint8_t position = 0;
+	uint8_t channel = 0;
+	uint8_t distance = 0;
+	int8_t direction = 1;
+
+	/* initialize peripherals */
+	softpwm_init();
+
+	/* global interrupt enable */
+  sei();
+
+    while (1) {
+			/* SUPERLOOP */
+
+			/* the spot at position, the tail behind it */
+			for(channel = 0; channel < SOFTPWM_CHANNELS; channel++) {
+				distance = (direction > 0) ? (position - channel) : (channel - position);
+				/* negative distances wrap to large values, that is ahead of
+				 * the spot */
+				softpwm_set(channel, (distance < TAIL_LENGTH) ? tail[distance] : 0);
+			}
+			/* all channels in the same period */
+			softpwm_commit();
+
+			/* turn around at both ends */
+			if((position + direction) >= SOFTPWM_CHANNELS || (position + direction) < 0) {
+				direction = -direction;
+			}
+			position += direction;
+
+			_delay_ms(STEP_DELAY);
+    }
+}
@@ -0,0 +1,256 @@
+/*********************************************************************
+ * Software PWM - C File
+ * Short Name: softpwm
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: PWM on any pin of port B, C and D, driven by the
+ *							compare match interrupt of Timer2
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+#include "softpwm.h"
+
+/*********************************************************************
+ * TYPES
+ *********************************************************************/
+/* pin of a channel */
+struct softpwm_pin {
+	uint8_t port;
+	uint8_t mask;
+};
+
+/* an edge, the first one of a list is the start of the period and
+ * holds the pins to set, all others the pins to clear */
+struct softpwm_edge {
+	/* counts to the next edge */
+	uint8_t gap;
+	uint8_t mask[SOFTPWM_PORTS];
+};
+
+/*********************************************************************
+ * VARIABLES
+ *********************************************************************/
+static const struct softpwm_pin softpwm_pins[SOFTPWM_CHANNELS] PROGMEM = {
+	SOFTPWM_PINS
+};
+
+/* all pins of the channels per port, filled by softpwm_init */
+static uint8_t port_mask[SOFTPWM_PORTS];
+
+/* written by softpwm_set */
+static uint8_t duties[SOFTPWM_CHANNELS];
+
+/* the two lists of edges, at most one edge per channel plus the
+ * start */
+static struct softpwm_edge edges[2][SOFTPWM_CHANNELS + 1];
+static uint8_t edge_count[2];
+
+/* list used by the ISR */
+static volatile uint8_t active = 0;
+/* set by softpwm_commit, the ISR switches lists at the next start */
+static volatile uint8_t swap_pending = 0;
+
+/* next edge of the ISR */
+static uint8_t edge_index = 0;
+
+/*********************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *********************************************************************/
+
+/**
+ * @brief builds a list of edges from the duty cycles
+ * @param list 0 or 1, must not be used by the ISR
+ * @return void
+ */
+static void softpwm_build(uint8_t list);
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+void softpwm_init(void) {
+
+	uint8_t i = 0;
+
+	for(i = 0; i < SOFTPWM_PORTS; i++) {
+		port_mask[i] = 0;
+	}
+	for(i = 0; i < SOFTPWM_CHANNELS; i++) {
+		duties[i] = 0;
+		port_mask[pgm_read_byte(&softpwm_pins[i].port)] |= pgm_read_byte(&softpwm_pins[i].mask);
+	}
+
+	/* all channels low and output */
+	PORTB &= ~port_mask[SOFTPWM_PORT_B];
+	PORTC &= ~port_mask[SOFTPWM_PORT_C];
+	PORTD &= ~port_mask[SOFTPWM_PORT_D];
+	DDRB |= port_mask[SOFTPWM_PORT_B];
+	DDRC |= port_mask[SOFTPWM_PORT_C];
+	DDRD |= port_mask[SOFTPWM_PORT_D];
+
+	/* one list with the start only */
+	softpwm_build(0);
+	active = 0;
+	swap_pending = 0;
+	edge_index = 0;
+
+	/* Timer2 in CTC mode, the first match starts the first period */
+	TCCR2B = 0;
+	TCNT2 = 0;
+	TCCR2A = (1 << WGM21);
+	OCR2A = SOFTPWM_STEPS - 1;
+	TIFR2 = (1 << OCF2A);
+	TIMSK2 |= (1 << OCIE2A);
+	TCCR2B = SOFTPWM_CS;
+}
+
+uint8_t softpwm_set(uint8_t channel, uint8_t duty) {
+
+	if((channel >= SOFTPWM_CHANNELS) || (duty > SOFTPWM_STEPS)) {
+		return 1;
+	}
+
+	duties[channel] = duty;
+
+	return 0;
+}
+
+void softpwm_commit(void) {
+
+	uint8_t sreg = SREG;
+	uint8_t list = 0;
+
+	/* without a pending switch the ISR stays on its list, the other
+	 * one is free to build */
+	cli();
+	swap_pending = 0;
+	list = active ^ 1;
+	SREG = sreg;
+
+	softpwm_build(list);
+
+	cli();
+	swap_pending = 1;
+	SREG = sreg;
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ *********************************************************************/
+static void softpwm_build(uint8_t list) {
+
+	uint8_t order[SOFTPWM_CHANNELS];
+	uint8_t i = 0;
+	uint8_t j = 0;
+	uint8_t channel = 0;
+	uint8_t port = 0;
+	uint8_t mask = 0;
+	uint8_t time = 0;
+	uint8_t last = 0;
+	uint8_t count = 1;
+	struct softpwm_edge *edge = &edges[list][0];
+
+	/* channels sorted by duty cycle, insertion sort, the table is
+	 * short and mostly sorted from the last commit */
+	for(i = 0; i < SOFTPWM_CHANNELS; i++) {
+		channel = i;
+		for(j = i; (j > 0) && (duties[order[j - 1]] > duties[channel]); j--) {
+			order[j] = order[j - 1];
+		}
+		order[j] = channel;
+	}
+
+	/* the start */
+	for(port = 0; port < SOFTPWM_PORTS; port++) {
+		edge[0].mask[port] = 0;
+	}
+
+	for(i = 0; i < SOFTPWM_CHANNELS; i++) {
+
+		channel = order[i];
+		if(duties[channel] == 0) {
+			continue;
+		}
+		port = pgm_read_byte(&softpwm_pins[channel].port);
+		mask = pgm_read_byte(&softpwm_pins[channel].mask);
+		edge[0].mask[port] |= mask;
+		/* always on, no edge, also too close to the end of the period */
+		if(duties[channel] > (SOFTPWM_STEPS - SOFTPWM_MIN_GAP)) {
+			continue;
+		}
+
+		/* keep SOFTPWM_MIN_GAP to the start */
+		time = duties[channel];
+		if(time < SOFTPWM_MIN_GAP) {
+			time = SOFTPWM_MIN_GAP;
+		}
+
+		if((count > 1) && ((uint8_t)(time - last) < SOFTPWM_MIN_GAP)) {
+			/* too close, ends with the edge before */
+			edge[count - 1].mask[port] |= mask;
+		} else {
+			edge[count - 1].gap = time - last;
+			edge[count].mask[SOFTPWM_PORT_B] = 0;
+			edge[count].mask[SOFTPWM_PORT_C] = 0;
+			edge[count].mask[SOFTPWM_PORT_D] = 0;
+			edge[count].mask[port] = mask;
+			last = time;
+			count++;
+		}
+	}
+	/* the last edge runs to the end of the period */
+	edge[count - 1].gap = SOFTPWM_STEPS - last;
+	edge_count[list] = count;
+}
+
+/*********************************************************************
+ * INTERRUPT SERVICE ROUTINES
+ *********************************************************************/
+/* an edge, OCR2A is loaded with the time to the next one */
+ISR (TIMER2_COMPA_vect) {
+
+	uint8_t list = active;
+	uint8_t i = edge_index;
+	const struct softpwm_edge *edge;
+
+	if(i == 0) {
+		/* start of a period, the only place to switch lists */
+		if(swap_pending) {
+			list ^= 1;
+			active = list;
+			swap_pending = 0;
+		}
+		edge = &edges[list][0];
+		/* all channels at once, also clears channels that were on for
+		 * the whole last period */
+		PORTB = (PORTB & ~port_mask[SOFTPWM_PORT_B]) | edge->mask[SOFTPWM_PORT_B];
+		PORTC = (PORTC & ~port_mask[SOFTPWM_PORT_C]) | edge->mask[SOFTPWM_PORT_C];
+		PORTD = (PORTD & ~port_mask[SOFTPWM_PORT_D]) | edge->mask[SOFTPWM_PORT_D];
+	} else {
+		edge = &edges[list][i];
+		PORTB &= ~edge->mask[SOFTPWM_PORT_B];
+		PORTC &= ~edge->mask[SOFTPWM_PORT_C];
+		PORTD &= ~edge->mask[SOFTPWM_PORT_D];
+	}
+	/* the counter restarted at the match, so the gap is relative */
+	OCR2A = edge->gap - 1;
+
+	if(++i >= edge_count[list]) {
+		i = 0;
+	}
+	edge_index = i;
+}
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
@@ -0,0 +1,105 @@
+/*********************************************************************
+ * Software PWM - Header File
+ * Short Name: softpwm
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: PWM on any pin of port B, C and D, driven by the
+ *							compare match interrupt of Timer2
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * NOTES:	softpwm_commit sorts the channels by their duty cycle and
+ *				turns them into a list of edges. An edge holds one mask per
+ *				port with all channels that end at that time, channels with
+ *				the same duty cycle share an edge. Timer2 runs in CTC mode
+ *				and OCR2A is loaded with the time to the next edge, so the
+ *				ISR only runs at edges: at the start of a period it sets
+ *				all pins that are on, at every other edge it clears the
+ *				pins of its masks, one write per port, no matter how many
+ *				channels there are.
+ *
+ *				There are two lists. softpwm_commit builds the one that is
+ *				not in use and the ISR switches over at the start of the
+ *				next period, so a period is never a mix of old and new
+ *				duty cycles.
+ *
+ *				softpwm_set(0, 10);
+ *				softpwm_set(17, 200);
+ *				softpwm_commit();
+ *
+ *				Edges closer than SOFTPWM_MIN_GAP are moved together, so
+ *				duty cycles just above 0 or below SOFTPWM_STEPS and close
+ *				neighbours can be off by up to SOFTPWM_MIN_GAP - 1 steps.
+ *
+ *				CPU load, counted from the code, not measured: an edge
+ *				takes about 75 cycles including entry and exit, a period
+ *				has at most one edge per distinct duty cycle plus the start.
+ *				At 16 MHz and 245 Hz a period is 65280 cycles:
+ *
+ *				channels	edges		load
+ *				1					2				0.2 %
+ *				8					9				1.0 %
+ *				16				17			2.0 %
+ *				24				25			2.9 %
+ *
+ *				about 0.12 % per channel with a distinct duty cycle. Channels
+ *				with equal duty cycles, 0 or SOFTPWM_STEPS cost nothing.
+ *				softpwm_commit runs in the main loop, the insertion sort
+ *				takes around 20 * SOFTPWM_CHANNELS^2 cycles at worst.
+ *
+ *				The ISR writes the whole port registers. Change other
+ *				pins of port B, C and D with interrupts disabled or by
+ *				writing PINx, else the ISR can undo the change.
+ *
+ *				Timer2 belongs to this module.
+ *********************************************************************/
+
+#ifndef SOFTPWM_H
+#define SOFTPWM_H
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/io.h>
+#include <stdint.h>
+
+#include "softpwm_cfg.h"
+
+/*********************************************************************
+ * FUNCTION PROTOTYPES
+ *********************************************************************/
+
+/**
+ * @brief sets the pins of all channels to output and low and starts
+ * Timer2 with all duty cycles at 0
+ * NOTE: needs global interrupts
+ * @return void
+ */
+void softpwm_init(void);
+
+/**
+ * @brief stores a duty cycle, it is applied by softpwm_commit
+ * @param channel number of the channel in SOFTPWM_PINS
+ * @param duty duty cycle in steps [0 - SOFTPWM_STEPS]
+ * @return 0 on success, 1 if the channel or duty cycle is out of range
+ */
+uint8_t softpwm_set(uint8_t channel, uint8_t duty);
+
+/**
+ * @brief builds the edges of all stored duty cycles, they are applied
+ * at the start of the next period, a commit that was not applied yet
+ * is replaced
+ * @return void
+ */
+void softpwm_commit(void);
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
+#endif
@@ -0,0 +1,87 @@
+/*********************************************************************
+ * Software PWM - Configuration File
+ * Short Name: softpwm_cfg
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: Settings for the software PWM, pins of the channels
+ *							and the clock of Timer2
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+#ifndef SOFTPWM_CFG_H
+#define SOFTPWM_CFG_H
+
+/* set CPU frequency for the PWM frequency */
+#ifndef F_CPU
+	#warning "SOFTPWM_CFG: F_CPU was undefined setting to 16 MHz"
+	#define F_CPU 16000000UL
+#endif
+
+/* ports a channel can be on */
+#define SOFTPWM_PORT_B 0
+#define SOFTPWM_PORT_C 1
+#define SOFTPWM_PORT_D 2
+#define SOFTPWM_PORTS 3
+
+/* a channel on pin <port><bit>, e.g. SOFTPWM_PIN(B, 3) for pin B3 */
+#define SOFTPWM_PIN(port, bit) { SOFTPWM_PORT_##port, (1 << (bit)) }
+
+/*********************************************************************
+ * SETTINGS
+ *********************************************************************/
+/* NOTE: the channels in the order of their number, any pin of port B,
+ * C and D. Pins D0 and D1 are left out for the UART, B6 and B7 are
+ * the crystal on the arduino. */
+#define SOFTPWM_CHANNELS 18
+#define SOFTPWM_PINS \
+	SOFTPWM_PIN(B, 0), SOFTPWM_PIN(B, 1), SOFTPWM_PIN(B, 2), \
+	SOFTPWM_PIN(B, 3), SOFTPWM_PIN(B, 4), SOFTPWM_PIN(B, 5), \
+	SOFTPWM_PIN(C, 0), SOFTPWM_PIN(C, 1), SOFTPWM_PIN(C, 2), \
+	SOFTPWM_PIN(C, 3), SOFTPWM_PIN(C, 4), SOFTPWM_PIN(C, 5), \
+	SOFTPWM_PIN(D, 2), SOFTPWM_PIN(D, 3), SOFTPWM_PIN(D, 4), \
+	SOFTPWM_PIN(D, 5), SOFTPWM_PIN(D, 6), SOFTPWM_PIN(D, 7)
+
+/* NOTE: a period has SOFTPWM_STEPS counts of Timer2, duty cycle 0 is
+ * off and SOFTPWM_STEPS is on. The frequency is
+ * F_CPU / (SOFTPWM_PRESCALER * SOFTPWM_STEPS), 245 Hz at 16 MHz. */
+#define SOFTPWM_PRESCALER 256
+#define SOFTPWM_STEPS 255
+
+/* NOTE: the ISR has to set the next compare value before Timer2
+ * reaches it, otherwise the match is missed and the period gets 256
+ * counts longer. Edges closer than SOFTPWM_MIN_GAP counts are moved
+ * together, 2 counts are 512 cycles at prescaler 256, that is enough
+ * for the ISR and some latency of other interrupts. */
+#define SOFTPWM_MIN_GAP 2
+
+/*********************************************************************
+ * DERIVED VALUES
+ *********************************************************************/
+/* clock select bits CS22:0 of Timer2 */
+#define SOFTPWM_CS (((SOFTPWM_PRESCALER) == 1) ? 1 : ((SOFTPWM_PRESCALER) == 8) ? 2 : \
+										((SOFTPWM_PRESCALER) == 32) ? 3 : ((SOFTPWM_PRESCALER) == 64) ? 4 : \
+										((SOFTPWM_PRESCALER) == 128) ? 5 : ((SOFTPWM_PRESCALER) == 256) ? 6 : \
+										((SOFTPWM_PRESCALER) == 1024) ? 7 : 0)
+
+/* frequency in Hz, rounded down */
+#define SOFTPWM_FREQUENCY (F_CPU / ((unsigned long)SOFTPWM_PRESCALER * SOFTPWM_STEPS))
+
+#if SOFTPWM_CS == 0
+	#error "SOFTPWM_CFG: SOFTPWM_PRESCALER must be 1, 8, 32, 64, 128, 256 or 1024"
+#endif
+#if (SOFTPWM_CHANNELS < 1) || (SOFTPWM_CHANNELS > 24)
+	#error "SOFTPWM_CFG: SOFTPWM_CHANNELS must be in [1 - 24]"
+#endif
+#if (SOFTPWM_STEPS < 16) || (SOFTPWM_STEPS > 255)
+	#error "SOFTPWM_CFG: SOFTPWM_STEPS must be in [16 - 255]"
+#endif
+#if (SOFTPWM_MIN_GAP < 2) || ((SOFTPWM_MIN_GAP * 4) > SOFTPWM_STEPS)
+	#error "SOFTPWM_CFG: SOFTPWM_MIN_GAP must be in [2 - SOFTPWM_STEPS / 4]"
+#endif
+
+#endif
@@ -0,0 +1,208 @@
+/*********************************************************************
+ * Input Capture - C File
+ * Short Name: capture
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: timestamps the edges on ICP1 (pin B0) with Timer1,
+ *							period, duty cycle and frequency of the signal
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/interrupt.h>
+
+#include "capture.h"
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+#define CAPTURE_BUFFER_MASK (CAPTURE_BUFFER_SIZE - 1)
+
+/*********************************************************************
+ * VARIABLES
+ *********************************************************************/
+/* ring buffer, head is written by the ISR, tail by capture_read */
+static volatile struct capture_event capture_buffer[CAPTURE_BUFFER_SIZE];
+static volatile uint8_t capture_head = 0;
+static volatile uint8_t capture_tail = 0;
+static volatile uint16_t capture_lost = 0;
+
+/* upper 16 bit of the time, counted by the overflow ISR */
+static volatile uint16_t capture_overflows = 0;
+
+/* state of capture_update */
+static uint32_t last_rising = 0;
+static uint32_t last_edge = 0;
+static uint8_t have_edge = 0;
+static uint8_t have_falling = 0;
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+void capture_init(void) {
+
+	uint8_t sreg = SREG;
+
+	cli();
+	capture_head = 0;
+	capture_tail = 0;
+	capture_lost = 0;
+	have_edge = 0;
+	have_falling = 0;
+	SREG = sreg;
+}
+
+uint8_t capture_read(struct capture_event *event) {
+
+	uint8_t tail = capture_tail;
+
+	if(tail == capture_head) {
+		return 0;
+	}
+	event->time = capture_buffer[tail].time;
+	event->rising = capture_buffer[tail].rising;
+	/* hand the slot back to the ISR after it was copied */
+	capture_tail = (tail + 1) & CAPTURE_BUFFER_MASK;
+
+	return 1;
+}
+
+uint8_t capture_update(struct capture_signal *signal) {
+
+	struct capture_event event;
+	uint8_t complete = 0;
+
+	while(capture_read(&event)) {
+#if TIMER1_CAPTURE_EDGE == TIMER_EDGE_BOTH
+		if(event.rising) {
+			/* rising, falling, rising is a whole period */
+			if(have_edge && have_falling) {
+				signal->period = event.time - last_rising;
+				signal->high = last_edge - last_rising;
+				complete = 1;
+			}
+			last_rising = event.time;
+			have_edge = 1;
+			have_falling = 0;
+		} else if(have_edge) {
+			last_edge = event.time;
+			have_falling = 1;
+		}
+#else
+		/* one edge per period */
+		if(have_edge) {
+			signal->period = event.time - last_edge;
+			signal->high = 0;
+			complete = 1;
+		}
+		last_edge = event.time;
+		have_edge = 1;
+#endif
+	}
+
+	return complete;
+}
+
+uint16_t capture_dropped(void) {
+
+	uint8_t sreg = SREG;
+	uint16_t lost = 0;
+
+	cli();
+	lost = capture_lost;
+	SREG = sreg;
+
+	return lost;
+}
+
+uint32_t capture_now(void) {
+
+	uint8_t sreg = SREG;
+	uint16_t low = 0;
+	uint16_t high = 0;
+
+	cli();
+	low = TCNT1;
+	high = capture_overflows;
+	/* an overflow after cli is not counted yet, a small count with the
+	 * flag set is after it */
+	if((TIFR1 & (1 << TOV1)) && (low < 0x8000)) {
+		high++;
+	}
+	SREG = sreg;
+
+	return ((uint32_t)high << 16) | low;
+}
+
+uint32_t capture_frequency_mhz(uint32_t period) {
+
+	if(period == 0) {
+		return 0;
+	}
+
+	/* 64 bit, CAPTURE_CLOCK * 1000 does not fit 32 bit at 16 MHz */
+	return (uint32_t)(((uint64_t)CAPTURE_CLOCK * 1000ULL + (period >> 1)) / period);
+}
+
+uint16_t capture_duty_permille(const struct capture_signal *signal) {
+
+	if(signal->period == 0) {
+		return 0;
+	}
+
+	return (uint16_t)(((uint64_t)signal->high * 1000ULL) / signal->period);
+}
+
+uint32_t capture_ticks_to_us(uint32_t ticks) {
+	return (uint32_t)(((uint64_t)ticks * 1000000ULL) / CAPTURE_CLOCK);
+}
+
+/*********************************************************************
+ * INTERRUPT SERVICE ROUTINES
+ *********************************************************************/
+/* an edge on ICP1, the time is already in ICR1 */
+ISR (TIMER1_CAPT_vect) {
+
+	uint16_t low = ICR1;
+	uint16_t high = capture_overflows;
+	uint8_t rising = (TCCR1B & (1 << ICES1)) ? 1 : 0;
+	uint8_t head = capture_head;
+	uint8_t next = (head + 1) & CAPTURE_BUFFER_MASK;
+
+	/* the capture interrupt comes first, an overflow that is pending
+	 * together with a small capture value happened before the edge */
+	if((TIFR1 & (1 << TOV1)) && (low < 0x8000)) {
+		high++;
+	}
+
+#if TIMER1_CAPTURE_EDGE == TIMER_EDGE_BOTH
+	/* the other edge next, the flag has to be cleared after the
+	 * change, see section 15.6.3 of the ATmega328p datasheet */
+	TCCR1B ^= (1 << ICES1);
+	TIFR1 = (1 << ICF1);
+#endif
+
+	if(next == capture_tail) {
+		capture_lost++;
+		return;
+	}
+	capture_buffer[head].time = ((uint32_t)high << 16) | low;
+	capture_buffer[head].rising = rising;
+	capture_head = next;
+}
+
+/* extends the 16 bit of Timer1 */
+ISR (TIMER1_OVF_vect) {
+	capture_overflows++;
+}
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
@@ -0,0 +1,158 @@
+/*********************************************************************
+ * Input Capture - Header File
+ * Short Name: capture
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: timestamps the edges on ICP1 (pin B0) with Timer1,
+ *							period, duty cycle and frequency of the signal
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * NOTES:	Timer1 is set up by timer_init, TIMER1_MODE has to be
+ *				TIMER_MODE_CAPTURE with TIMER1_INTERRUPT 1, the edge and
+ *				the noise canceler are set in timer_cfg.h. On an edge the
+ *				hardware copies TCNT1 to ICR1, so the time is exact to one
+ *				timer count no matter how late the ISR runs. The ISR adds
+ *				the overflows counted by the overflow ISR as the upper 16
+ *				bit and puts the 32 bit time into a ring buffer, nothing
+ *				else. Period, duty cycle and frequency are calculated by
+ *				the functions below, outside the ISR.
+ *
+ *				With TIMER_EDGE_BOTH the ISR switches the edge after every
+ *				capture, pulses shorter than the ISR, about 5 us, are
+ *				missed. The noise canceler delays every edge by 4 timer
+ *				counts, the period and duty cycle do not change.
+ *
+ *				struct capture_signal signal;
+ *				if(capture_update(&signal)) {
+ *					hz = capture_frequency_mhz(signal.period) / 1000;
+ *				}
+ *
+ *				At 16 MHz and prescaler 1 a count is 62.5 ns and the 32
+ *				bit time wraps after 268 s, periods up to that length can
+ *				be measured.
+ *********************************************************************/
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/io.h>
+#include <stdint.h>
+
+#include "timer.h"
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* edges the ring buffer holds, power of 2, 6 bytes each */
+#ifndef CAPTURE_BUFFER_SIZE
+	#define CAPTURE_BUFFER_SIZE 16
+#endif
+
+/* counts of Timer1 per second */
+#define CAPTURE_CLOCK (F_CPU / TIMER1_PRESCALER)
+
+#if TIMER1_MODE != TIMER_MODE_CAPTURE
+	#error "CAPTURE: set TIMER1_MODE to TIMER_MODE_CAPTURE in timer_cfg.h"
+#endif
+#if TIMER1_INTERRUPT != 1
+	#error "CAPTURE: set TIMER1_INTERRUPT to 1 in timer_cfg.h"
+#endif
+#if (CAPTURE_BUFFER_SIZE < 2) || (CAPTURE_BUFFER_SIZE > 128) || \
+		(CAPTURE_BUFFER_SIZE & (CAPTURE_BUFFER_SIZE - 1))
+	#error "CAPTURE: CAPTURE_BUFFER_SIZE must be a power of 2 in [2 - 128]"
+#endif
+
+/*********************************************************************
+ * TYPES
+ *********************************************************************/
+/* an edge */
+struct capture_event {
+	/* counts of Timer1 since timer_init */
+	uint32_t time;
+	/* 1 rising, 0 falling */
+	uint8_t rising;
+};
+
+/* the last complete period, in counts of Timer1 */
+struct capture_signal {
+	uint32_t period;
+	/* time between the rising and the falling edge, only with
+	 * TIMER_EDGE_BOTH, else 0 */
+	uint32_t high;
+};
+
+/*********************************************************************
+ * FUNCTION PROTOTYPES
+ *********************************************************************/
+
+/**
+ * @brief empties the ring buffer and resets the measurement, call
+ * after timer_init and before sei
+ * @return void
+ */
+void capture_init(void);
+
+/**
+ * @brief takes the oldest edge out of the ring buffer
+ * NOTE: do not combine with capture_update, it takes the edges too
+ * @param event the edge
+ * @return 1 if there was an edge, else 0
+ */
+uint8_t capture_read(struct capture_event *event);
+
+/**
+ * @brief takes all edges out of the ring buffer and measures the
+ * signal
+ * @param signal the last complete period, only written on success
+ * @return 1 if a new period was completed, else 0
+ */
+uint8_t capture_update(struct capture_signal *signal);
+
+/**
+ * @brief edges lost because the ring buffer was full
+ * @return number of edges
+ */
+uint16_t capture_dropped(void);
+
+/**
+ * @brief current time on the scale of the edges, e.g. to detect that
+ * the signal stopped
+ * @return counts of Timer1 since timer_init
+ */
+uint32_t capture_now(void);
+
+/**
+ * @brief frequency of a period
+ * @param period counts of Timer1
+ * @return frequency in mHz, 0 for a period of 0
+ */
+uint32_t capture_frequency_mhz(uint32_t period);
+
+/**
+ * @brief duty cycle of a signal, needs TIMER_EDGE_BOTH
+ * @param signal the measured signal
+ * @return duty cycle in permille
+ */
+uint16_t capture_duty_permille(const struct capture_signal *signal);
+
+/**
+ * @brief converts counts of Timer1 to microseconds
+ * @param ticks counts
+ * @return microseconds, rounded down
+ */
+uint32_t capture_ticks_to_us(uint32_t ticks);
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
+#endif
@@ -0,0 +1,152 @@
+/*********************************************************************
+ * Timer Driver - C File
+ * Short Name: timer
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: sets up Timer0, Timer1 and Timer2 as configured in 
+ *							timer_cfg.h
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ * [17.10.2026][nmt]: capture on both edges starts with rising
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include "timer.h"
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* the clock select bits are the lowest 3 bits of TCCRnB */
+#define TIMER_CS_MASK 0x07
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+
+/* NOTE: to follow along below, refer to sections 14 (Timer0), 15 
+ * (Timer1) and 17 (Timer2) of the ATmega328p datasheet */
+
+void timer_init(void) {
+
+#if TIMER0_MODE != TIMER_MODE_OFF
+	/* stop the timer while it is set up */
+	TCCR0B = 0;
+	TCNT0 = 0;
+#if TIMER0_MODE == TIMER_MODE_CTC
+	/* clear on compare match with OCR0A, table 14-8 */
+	TCCR0A = (1 << WGM01);
+	OCR0A = TIMER0_OCR;
+#if TIMER0_INTERRUPT
+	TIFR0 = (1 << OCF0A);
+	TIMSK0 |= (1 << OCIE0A);
+#endif
+#else
+	/* normal mode, counts to 0xff */
+	TCCR0A = 0;
+#if TIMER0_INTERRUPT
+	TIFR0 = (1 << TOV0);
+	TIMSK0 |= (1 << TOIE0);
+#endif
+#endif
+	TCCR0B = TIMER0_CS;
+#endif
+
+#if TIMER1_MODE != TIMER_MODE_OFF
+	TCCR1B = 0;
+	TCCR1A = 0;
+	TCNT1 = 0;
+#if TIMER1_MODE == TIMER_MODE_CTC
+	/* clear on compare match with OCR1A, table 15-5 */
+	OCR1A = TIMER1_OCR;
+#if TIMER1_INTERRUPT
+	TIFR1 = (1 << OCF1A);
+	TIMSK1 |= (1 << OCIE1A);
+#endif
+	TCCR1B = (1 << WGM12) | TIMER1_CS;
+#elif TIMER1_MODE == TIMER_MODE_CAPTURE
+	/* ICP1 (pin B0) as input, the counter value is copied to ICR1 on
+	 * the selected edge */
+	DDRB &= ~(1 << DDB0);
+#if TIMER1_INTERRUPT
+	/* the overflow interrupt lets the application extend the 16 bit
+	 * of ICR1 */
+	TIFR1 = (1 << ICF1) | (1 << TOV1);
+	TIMSK1 |= (1 << ICIE1) | (1 << TOIE1);
+#endif
+	TCCR1B = (TIMER1_NOISE_CANCELER ? (1 << ICNC1) : 0) |
+					 ((TIMER1_CAPTURE_EDGE != TIMER_EDGE_FALLING) ? (1 << ICES1) : 0) |
+					 TIMER1_CS;
+#else
+	/* normal mode, counts to 0xffff */
+#if TIMER1_INTERRUPT
+	TIFR1 = (1 << TOV1);
+	TIMSK1 |= (1 << TOIE1);
+#endif
+	TCCR1B = TIMER1_CS;
+#endif
+#endif
+
+#if TIMER2_MODE != TIMER_MODE_OFF
+	TCCR2B = 0;
+	TCNT2 = 0;
+#if TIMER2_MODE == TIMER_MODE_CTC
+	/* clear on compare match with OCR2A, table 17-8 */
+	TCCR2A = (1 << WGM21);
+	OCR2A = TIMER2_OCR;
+#if TIMER2_INTERRUPT
+	TIFR2 = (1 << OCF2A);
+	TIMSK2 |= (1 << OCIE2A);
+#endif
+#else
+	TCCR2A = 0;
+#if TIMER2_INTERRUPT
+	TIFR2 = (1 << TOV2);
+	TIMSK2 |= (1 << TOIE2);
+#endif
+#endif
+	TCCR2B = TIMER2_CS;
+#endif
+}
+
+void timer_start(uint8_t timer) {
+	switch(timer) {
+		case TIMER_0:
+			TCCR0B = (TCCR0B & ~TIMER_CS_MASK) | TIMER0_CS;
+			break;
+		case TIMER_1:
+			TCCR1B = (TCCR1B & ~TIMER_CS_MASK) | TIMER1_CS;
+			break;
+		case TIMER_2:
+			TCCR2B = (TCCR2B & ~TIMER_CS_MASK) | TIMER2_CS;
+			break;
+		default:
+			break;
+	}
+}
+
+void timer_stop(uint8_t timer) {
+	/* no clock source stops the counter */
+	switch(timer) {
+		case TIMER_0:
+			TCCR0B &= ~TIMER_CS_MASK;
+			break;
+		case TIMER_1:
+			TCCR1B &= ~TIMER_CS_MASK;
+			break;
+		case TIMER_2:
+			TCCR2B &= ~TIMER_CS_MASK;
+			break;
+		default:
+			break;
+	}
+}
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
@@ -0,0 +1,78 @@
+/*********************************************************************
+ * Timer Driver - Header File
+ * Short Name: timer
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: sets up Timer0, Timer1 and Timer2 as configured in 
+ *							timer_cfg.h
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * NOTES:	choose mode and period of each timer in timer_cfg.h, the 
+ *				prescaler and compare value are calculated at compile time.
+ *				The resulting period and its error are available as 
+ *				TIMERn_PERIOD_NS and TIMERn_ERROR_PERMILLE. The driver 
+ *				only sets up the registers, the ISRs are up to the 
+ *				application:
+ *
+ *				CTC:			TIMERn_COMPA_vect
+ *				normal:		TIMERn_OVF_vect
+ *				capture:	TIMER1_CAPT_vect (ICR1 holds the count) and
+ *									TIMER1_OVF_vect, input on pin B0 (ICP1)
+ *********************************************************************/
+
+#ifndef TIMER_H
+#define TIMER_H
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/io.h>
+#include <stdint.h>
+
+#include "timer_cfg.h"
+
+/*********************************************************************
+ * TYPES
+ *********************************************************************/
+/* the timers of the ATmega328p */
+enum TIMERS {
+	TIMER_0,
+	TIMER_1,
+	TIMER_2
+};
+
+/*********************************************************************
+ * FUNCTION PROTOTYPES
+ *********************************************************************/
+
+/**
+ * @brief sets up and starts all timers that are not TIMER_MODE_OFF
+ * @return void
+ */
+void timer_init(void);
+
+/**
+ * @brief starts a timer with its configured prescaler
+ * @param timer one of TIMERS
+ * @return void
+ */
+void timer_start(uint8_t timer);
+
+/**
+ * @brief stops a timer, the counter keeps its value
+ * @param timer one of TIMERS
+ * @return void
+ */
+void timer_stop(uint8_t timer);
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
+#endif
@@ -1,23 +1,30 @@
 /*********************************************************************
  * 16-bit Timer Driver - Demo Program
- * Short Name: timer_8bit
+ * Short Name: timer_16bit
  * Author: nmt @ NT-COM
  * Date: 20.09.2019
- * Description:		sets up the 16-bit timer, triggers an interrupt on
- *								compare match
+ * Description:		measures frequency and duty cycle of a signal with the
+ *								input capture of the 16-bit timer
  *********************************************************************/
 
 /*********************************************************************
  * Changelog:
  * [Date][Author]:[Change]
  * [20.09.2019][nmt]: initial commit
+ * [17.10.2026][nmt]: simavr support, see the sim target
+ * [17.10.2026][nmt]: the timer is set up by the timer driver
+ * [17.10.2026][nmt]: measures a test signal with the input capture
  *********************************************************************/
 
 /*********************************************************************
  * Usage: 
  *
- * Connect a LED to pin B1 on the arduino, that way you can see 
- * when a timer interrupt occurs. 
+ * Connect pin B3 to pin B0 and a LED to pin B1 on the arduino. Timer2
+ * toggles B3 at every compare match, a square wave of 500 Hz, and
+ * Timer1 timestamps both edges on ICP1 (pin B0), see timer_cfg.h. The
+ * main loop measures every period and turns the LED on while the
+ * frequency and the duty cycle are within 1 % of 500 Hz and 50 %. If
+ * no edge comes for SIGNAL_TIMEOUT_US the LED is turned off.
  *********************************************************************/
 
 /*********************************************************************
@@ -25,62 +32,93 @@
  *********************************************************************/
 #include <avr/io.h> 
 #include <avr/interrupt.h>
-#include <util/delay.h>
+
+#include "timer.h"
+#include "capture.h"
 
 /*********************************************************************
  * MACROS
  *********************************************************************/ 
-/* set the CPU frequency to 4 MHz */
+/* set the CPU frequency to 16 MHz */
 #ifndef F_CPU
-	#define F_CPU 4000000UL
+	#define F_CPU 16000000UL
+#endif
+
+/* NOTE: only used for "make sim", tells simavr which MCU and clock to
+ * use and which registers to record in timer_16bit.vcd */
+#ifdef SIMAVR
+#include "avr_mcu_section.h"
+AVR_MCU(F_CPU, "atmega328p");
+AVR_MCU_VCD_FILE("timer_16bit.vcd", 1000);
+const struct avr_mmcu_vcd_trace_t simavr_trace[] _MMCU_ = {
+	{ AVR_MCU_VCD_SYMBOL("PB1"), .mask = (1 << PB1), .what = (void*)&PORTB, },
+	{ AVR_MCU_VCD_SYMBOL("PB3"), .mask = (1 << PB3), .what = (void*)&PORTB, },
+	{ AVR_MCU_VCD_SYMBOL("ICR1L"), .mask = 0xff, .what = (void*)&ICR1L, },
+	{ AVR_MCU_VCD_SYMBOL("ICR1H"), .mask = 0xff, .what = (void*)&ICR1H, },
+};
 #endif
 
-#define COUNTER_COMPARE_VALUE	0x3333
+/* expected signal and tolerance */
+#define SIGNAL_FREQUENCY_MHZ 500000UL
+#define SIGNAL_DUTY_PERMILLE 500
+#define SIGNAL_TOL_PERMILLE 10
+
+/* the LED is turned off if no period was completed for this time */
+#define SIGNAL_TIMEOUT_US 100000UL
+#define SIGNAL_TIMEOUT_TICKS ((uint32_t)((CAPTURE_CLOCK / 1000UL) * (SIGNAL_TIMEOUT_US / 1000UL)))
 
 /*********************************************************************
  * FUNCTION PROTOTYPES
  *********************************************************************/ 
 /**
- * @brief sets up the pin B1 to connect an LED
+ * @brief sets up the pin B1 to connect an LED and the test signal on
+ * pin B3
  * @return void
  */
 void gpio_setup(void);
 
 /**
- * @brief sets up the timer
- * @param comp_value the value to compare the counter value of the timer to
- * @return void
+ * @brief checks a measured signal against the expected one
+ * @param signal the measured signal
+ * @return 1 if frequency and duty cycle are within the tolerance
  */
-void timer_16_setup(uint16_t comp_value);
+uint8_t signal_ok(const struct capture_signal *signal);
 
 /*********************************************************************
  * MAIN FUNCTION
  *********************************************************************/ 
 int main(void) {
 
-	/* initialize peripherals */
+	struct capture_signal signal;
+	uint32_t last_period = 0;
+
+	/* Timer1 captures, Timer2 is the test signal, see timer_cfg.h */
+	timer_init();
+	capture_init();
 	gpio_setup();
-	timer_16_setup(COUNTER_COMPARE_VALUE);
 
 	/* global interrupt enable */
   sei();        
 
+	last_period = capture_now();
+
     while (1) {
 			/* SUPERLOOP */
-    }
-}
-
-/*********************************************************************
- * INTERRUPT SERVICE ROUTINE
- *********************************************************************/ 
-/* ISR triggered on timer1 compare match */
-ISR (TIMER1_COMPA_vect) {
-	
-	/* toggles the second bit in the register PINB points to, thus
-		 pin B1 is toggled. Note that '^' is not necessary, '=' handles
-		 the toggling. */	
-	PINB = 0x02;	
 
+			/* the edges are only timestamped in the ISR, all the math is
+			 * done here */
+			if(capture_update(&signal)) {
+				last_period = capture_now();
+				if(signal_ok(&signal)) {
+					PORTB |= (1 << PORTB1);
+				} else {
+					PORTB &= ~(1 << PORTB1);
+				}
+			} else if((capture_now() - last_period) > SIGNAL_TIMEOUT_TICKS) {
+				/* no signal */
+				PORTB &= ~(1 << PORTB1);
+			}
+    }
 }
 
 /*********************************************************************
@@ -90,43 +128,30 @@ void gpio_setup() {
 
 	/* gpio setup */
 
-	/* pin B1 to output */
-	DDRB = (1 << DDB1);
-	/* set the pin to low */
-	PINB &= ~(1 << PINB1);
-
-}
-
-void timer_16_setup(uint16_t comp_value) {
+	/* pin B1 and B3 to output, B0 stays an input for ICP1 */
+	DDRB |= (1 << DDB1) | (1 << DDB3);
+	/* set the LED to low */
+	PORTB &= ~(1 << PORTB1);
 
-	/* timer setup */
+	/* OC2A toggles on compare match, table 17-2 */
+	TCCR2A |= (1 << COM2A0);
 
-	/* NOTE: check out datasheet section 14 for more details */
-
-	/* NOTE:	This is the "Clear Timer on Compare Match (CTC) Mode" 
-						basically you set a value in OCR0A and the timer value 
-						is continuously compared to this value. Once it matches
-						the counter of the timer is cleared. When this happens
-						you can trigger an interrupt, which is exactly what we
-						are setting up below. To change what happens when an 
-						interrupt occurs add your code to the ISR above. */
-
-	/* this value is calculated as follows: 
-		 f_OCnA = CPU_CLOCK_FREQ / ( 2*PRESCALE_VALUE*(1+OCRnA) ) */	
-	OCR1A = comp_value;
+}
 
-	/*	this register is used with register TCCR1A to set counting sequence,
-			the maximum value for the counter and wave form generation. In this 
-			case, we are setting up CTC mode and checking OCR1A if we have a 
-			match. If you look in the datasheet table 15-5 describes this. */
-	TCCR1B |= (1 << WGM12);	
+uint8_t signal_ok(const struct capture_signal *signal) {
 
-	/* activate interrupt on compare match */
-	TIMSK1 |= (1 << OCIE1A);
+	uint32_t frequency = capture_frequency_mhz(signal->period);
+	uint16_t duty = capture_duty_permille(signal);
+	uint32_t tol = SIGNAL_FREQUENCY_MHZ / 1000UL * SIGNAL_TOL_PERMILLE;
 
-	/* set the prescaler to 1024 */
-	TCCR1B |= ( (1 << CS12) | (1 << CS10) );
+	if((frequency < (SIGNAL_FREQUENCY_MHZ - tol)) ||
+		 (frequency > (SIGNAL_FREQUENCY_MHZ + tol))) {
+		return 0;
+	}
+	if((duty < (SIGNAL_DUTY_PERMILLE - SIGNAL_TOL_PERMILLE)) ||
+		 (duty > (SIGNAL_DUTY_PERMILLE + SIGNAL_TOL_PERMILLE))) {
+		return 0;
+	}
 
+	return 1;
 }
-
-
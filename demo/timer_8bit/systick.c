@@ -0,0 +1,96 @@
+/*********************************************************************
+ * System Tick - C File
+ * Short Name: systick
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: 1 ms tick on Timer0, milliseconds and microseconds 
+ *							since start
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ * [17.10.2026][nmt]: optional timer wheel tick, see SYSTICK_WHEEL
+ * [17.10.2026][nmt]: 8 and 16 bit math with the 64 bit solver values
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/interrupt.h>
+
+#include "systick.h"
+#if SYSTICK_WHEEL
+	#include "wheel.h"
+#endif
+
+/*********************************************************************
+ * VARIABLES
+ *********************************************************************/
+/* milliseconds, only written by the ISR */
+static volatile uint32_t systick_ms = 0;
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+void systick_init(void) {
+
+	/* same as timer_init does for TIMER_MODE_CTC, see timer.c */
+	TCCR0B = 0;
+	TCNT0 = 0;
+	TCCR0A = (1 << WGM01);
+	OCR0A = SYSTICK_OCR;
+	TIFR0 = (1 << OCF0A);
+	TIMSK0 |= (1 << OCIE0A);
+	TCCR0B = SYSTICK_CS;
+}
+
+uint32_t systick_millis(void) {
+
+	uint8_t sreg = SREG;
+	uint32_t ms = 0;
+
+	/* 32 bit, the ISR could change it between the byte reads */
+	cli();
+	ms = systick_ms;
+	SREG = sreg;
+
+	return ms;
+}
+
+uint32_t systick_micros(void) {
+
+	uint8_t sreg = SREG;
+	uint32_t ms = 0;
+	uint8_t ticks = 0;
+
+	cli();
+	ms = systick_ms;
+	ticks = TCNT0;
+	/* the counter may have passed the compare match after cli, then 
+	 * the millisecond is not counted yet and TCNT0 started over. A 
+	 * count below OCR0A with the flag set can only be after the 
+	 * match. */
+	if((TIFR0 & (1 << OCF0A)) && (ticks < (uint8_t)SYSTICK_OCR)) {
+		ms++;
+	}
+	SREG = sreg;
+
+	return (ms * 1000UL) + ((uint16_t)ticks * (uint16_t)SYSTICK_US_PER_TICK);
+}
+
+/*********************************************************************
+ * INTERRUPT SERVICE ROUTINES
+ *********************************************************************/
+/* 1 ms tick */
+ISR (TIMER0_COMPA_vect) {
+	systick_ms++;
+#if SYSTICK_WHEEL
+	wheel_tick();
+#endif
+}
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
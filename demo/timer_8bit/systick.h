@@ -0,0 +1,103 @@
+/*********************************************************************
+ * System Tick - Header File
+ * Short Name: systick
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: 1 ms tick on Timer0, milliseconds and microseconds 
+ *							since start
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ * [17.10.2026][nmt]: optional timer wheel tick, see SYSTICK_WHEEL
+ *********************************************************************/
+
+/*********************************************************************
+ * NOTES:	Timer0 runs in CTC mode with a compare match every 1 ms, 
+ *				the ISR counts the milliseconds. systick_micros adds the 
+ *				current count of TCNT0, so it has the resolution of one 
+ *				timer tick (4 us at 16 MHz). Timer0 belongs to this module,
+ *				keep TIMER0_MODE at TIMER_MODE_OFF in timer_cfg.h.
+ *
+ *				Instead of _delay_ms, remember the start and compare the
+ *				difference, this also works when the counter wraps:
+ *
+ *				if((systick_millis() - start) >= timeout) { ... }
+ *
+ *				The tick ISR takes in the order of 60 cycles every
+ *				millisecond, about 0.4 % of the CPU at 16 MHz. The systick
+ *				rows of demo/benchmark measure it exactly.
+ *********************************************************************/
+
+#ifndef SYSTICK_H
+#define SYSTICK_H
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/io.h>
+#include <stdint.h>
+
+#include "timer_cfg.h"
+
+/*********************************************************************
+ * SETTINGS
+ *********************************************************************/
+/* 1 to call wheel_tick from the tick ISR, see wheel.h, the build 
+ * needs wheel.c then */
+#ifndef SYSTICK_WHEEL
+	#define SYSTICK_WHEEL 0
+#endif
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* the tick uses the solver of timer_cfg.h */
+#define SYSTICK_PERIOD_US 1000UL
+#define SYSTICK_PRESCALER TIMER_PS01(SYSTICK_PERIOD_US, 256UL)
+#define SYSTICK_CS TIMER_CS01(SYSTICK_PRESCALER)
+#define SYSTICK_TICKS TIMER_TICKS(SYSTICK_PERIOD_US, SYSTICK_PRESCALER)
+#define SYSTICK_OCR (SYSTICK_TICKS - 1)
+/* microseconds per count of TCNT0 */
+#define SYSTICK_US_PER_TICK (SYSTICK_PERIOD_US / SYSTICK_TICKS)
+
+/* the clock would drift otherwise, this is true for 8 and 16 MHz */
+#if (SYSTICK_TICKS * SYSTICK_PRESCALER * 1000UL) != F_CPU
+	#error "SYSTICK: F_CPU does not allow an exact 1 ms tick"
+#endif
+#if (SYSTICK_PERIOD_US % SYSTICK_TICKS) != 0
+	#error "SYSTICK: a timer tick is not a whole number of microseconds"
+#endif
+#if TIMER0_MODE != TIMER_MODE_OFF
+	#error "SYSTICK: Timer0 is used by the system tick, set TIMER0_MODE to TIMER_MODE_OFF"
+#endif
+
+/*********************************************************************
+ * FUNCTION PROTOTYPES
+ *********************************************************************/
+
+/**
+ * @brief starts Timer0 and the 1 ms tick interrupt
+ * NOTE: needs global interrupts
+ * @return void
+ */
+void systick_init(void);
+
+/**
+ * @brief milliseconds since systick_init
+ * @return milliseconds, wraps after 49.7 days
+ */
+uint32_t systick_millis(void);
+
+/**
+ * @brief microseconds since systick_init
+ * @return microseconds, wraps after 71.6 minutes
+ */
+uint32_t systick_micros(void);
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
+#endif
@@ -0,0 +1,207 @@
+/*********************************************************************
+ * Timer Driver - Configuration File
+ * Short Name: timer_cfg
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: Settings for Timer0, Timer1 and Timer2, prescaler and
+ *							compare values based on F_CPU
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ * [17.10.2026][nmt]: Timer0 is used by the system tick
+ * [17.10.2026][nmt]: capture on both edges
+ * [17.10.2026][nmt]: tick calculation in 64 bit, checked in C as well
+ *********************************************************************/
+
+#ifndef TIMER_CFG_H
+#define TIMER_CFG_H
+
+/* set CPU frequency for the prescaler calculation */
+#ifndef F_CPU
+	#warning "TIMER_CFG: F_CPU was undefined setting to 16 MHz"
+	#define F_CPU 16000000UL
+#endif
+
+/* modes of the timers */
+#define TIMER_MODE_OFF 0			/* not touched by timer_init */
+#define TIMER_MODE_NORMAL 1		/* counts up to the maximum and overflows */
+#define TIMER_MODE_CTC 2			/* counts up to OCRnA, then starts over */
+#define TIMER_MODE_CAPTURE 3	/* normal mode with input capture on ICP1,
+															 * Timer1 only */
+
+/* edges of the input capture */
+#define TIMER_EDGE_FALLING 0
+#define TIMER_EDGE_RISING 1
+#define TIMER_EDGE_BOTH 2		/* starts with rising, the ISR has to switch
+														 * ICES1 after each capture, see
+														 * demo/timer_16bit/capture.h */
+
+/*********************************************************************
+ * SETTINGS
+ *********************************************************************/
+/* NOTE: the period is in microseconds. In CTC mode it is the time
+ * between two compare matches. In normal and capture mode it is the
+ * time the counter should cover before it overflows, it only selects
+ * the prescaler. The interrupt of the mode (compare match A, overflow,
+ * or capture and overflow) is enabled if TIMERn_INTERRUPT is 1, the
+ * ISR belongs to the application. */
+
+/* Timer0, 8 bit, NOTE: used by the system tick, see systick.h */
+#define TIMER0_MODE TIMER_MODE_OFF
+#define TIMER0_PERIOD_US 1000UL
+#define TIMER0_INTERRUPT 1
+
+/* Timer1, 16 bit */
+#define TIMER1_MODE TIMER_MODE_OFF
+#define TIMER1_PERIOD_US 500000UL
+#define TIMER1_INTERRUPT 1
+/* capture mode only: edge and noise canceler, which delays the
+ * capture by 4 clock cycles of the timer */
+#define TIMER1_CAPTURE_EDGE TIMER_EDGE_RISING
+#define TIMER1_NOISE_CANCELER 0
+
+/* Timer2, 8 bit, toggles pin B2 */
+#define TIMER2_MODE TIMER_MODE_CTC
+#define TIMER2_PERIOD_US 10000UL
+#define TIMER2_INTERRUPT 1
+
+/* maximum error of a CTC period in percent, the build fails if the
+ * period can not be reached with this tolerance */
+#define TIMER_PERIOD_TOL 1
+
+/*********************************************************************
+ * SOLVER
+ *********************************************************************/
+/* NOTE: in CTC mode the period is calculated as follows, see sections
+ * 14.7.2, 15.9.2 and 17.7.2 of the ATmega328p datasheet:
+ * period = prescaler * (OCRnA + 1) / F_CPU
+ * The macros below pick the smallest prescaler, which gives the finest
+ * steps, whose counter still covers the period. They are constant, so
+ * they can be used in #if and cost nothing at run time. Timer0 and
+ * Timer1 have the prescalers 1, 8, 64, 256 and 1024, Timer2 has 32 and
+ * 128 in addition. */
+
+/* timer ticks of a period at a prescaler, rounded. NOTE: calculated
+ * in 64 bit, in 32 bit the product overflows for periods above about
+ * 268 ms at 16 MHz. The preprocessor always calculates in 64 bit, so 
+ * the #if checks would pass while the C code gets a wrong value. The
+ * result is unsigned long long, cast it in run time expressions. */
+#define TIMER_TICKS(us, ps) (((F_CPU / 1000ULL) * (us) + 500ULL * (ps)) / (1000ULL * (ps)))
+
+/* prescaler for Timer0 and Timer1, max is the range of the counter */
+#define TIMER_PS01(us, max) ((TIMER_TICKS(us, 1UL) <= (max)) ? 1UL : \
+													 (TIMER_TICKS(us, 8UL) <= (max)) ? 8UL : \
+													 (TIMER_TICKS(us, 64UL) <= (max)) ? 64UL : \
+													 (TIMER_TICKS(us, 256UL) <= (max)) ? 256UL : 1024UL)
+/* clock select bits CSn2:0 for a prescaler of Timer0 and Timer1 */
+#define TIMER_CS01(ps) (((ps) == 1UL) ? 1 : ((ps) == 8UL) ? 2 : \
+												((ps) == 64UL) ? 3 : ((ps) == 256UL) ? 4 : 5)
+
+/* prescaler for Timer2 */
+#define TIMER_PS2(us) ((TIMER_TICKS(us, 1UL) <= 256UL) ? 1UL : \
+											 (TIMER_TICKS(us, 8UL) <= 256UL) ? 8UL : \
+											 (TIMER_TICKS(us, 32UL) <= 256UL) ? 32UL : \
+											 (TIMER_TICKS(us, 64UL) <= 256UL) ? 64UL : \
+											 (TIMER_TICKS(us, 128UL) <= 256UL) ? 128UL : \
+											 (TIMER_TICKS(us, 256UL) <= 256UL) ? 256UL : 1024UL)
+/* clock select bits CS22:0 for a prescaler of Timer2 */
+#define TIMER_CS2(ps) (((ps) == 1UL) ? 1 : ((ps) == 8UL) ? 2 : \
+											 ((ps) == 32UL) ? 3 : ((ps) == 64UL) ? 4 : \
+											 ((ps) == 128UL) ? 5 : ((ps) == 256UL) ? 6 : 7)
+
+/* resulting period in nanoseconds and its error against the request
+ * in permille */
+#define TIMER_PERIOD_NS(ticks, ps) ((ticks) * (ps) * 1000000000ULL / F_CPU)
+#define TIMER_ERROR_PERMILLE(us, ns) ((((us) * 1000ULL) > (ns)) ? \
+	(((us) * 1000ULL - (ns)) / (us)) : (((ns) - (us) * 1000ULL) / (us)))
+
+/* Timer0 */
+#define TIMER0_PRESCALER TIMER_PS01(TIMER0_PERIOD_US, 256UL)
+#define TIMER0_CS TIMER_CS01(TIMER0_PRESCALER)
+#define TIMER0_TICKS TIMER_TICKS(TIMER0_PERIOD_US, TIMER0_PRESCALER)
+#define TIMER0_OCR (TIMER0_TICKS - 1)
+#if TIMER0_MODE == TIMER_MODE_CTC
+	#define TIMER0_PERIOD_NS TIMER_PERIOD_NS(TIMER0_TICKS, TIMER0_PRESCALER)
+#else
+	#define TIMER0_PERIOD_NS TIMER_PERIOD_NS(256ULL, TIMER0_PRESCALER)
+#endif
+#define TIMER0_ERROR_PERMILLE TIMER_ERROR_PERMILLE(TIMER0_PERIOD_US, TIMER0_PERIOD_NS)
+
+/* Timer1 */
+#define TIMER1_PRESCALER TIMER_PS01(TIMER1_PERIOD_US, 65536UL)
+#define TIMER1_CS TIMER_CS01(TIMER1_PRESCALER)
+#define TIMER1_TICKS TIMER_TICKS(TIMER1_PERIOD_US, TIMER1_PRESCALER)
+#define TIMER1_OCR (TIMER1_TICKS - 1)
+#if TIMER1_MODE == TIMER_MODE_CTC
+	#define TIMER1_PERIOD_NS TIMER_PERIOD_NS(TIMER1_TICKS, TIMER1_PRESCALER)
+#else
+	#define TIMER1_PERIOD_NS TIMER_PERIOD_NS(65536ULL, TIMER1_PRESCALER)
+#endif
+#define TIMER1_ERROR_PERMILLE TIMER_ERROR_PERMILLE(TIMER1_PERIOD_US, TIMER1_PERIOD_NS)
+
+/* Timer2 */
+#define TIMER2_PRESCALER TIMER_PS2(TIMER2_PERIOD_US)
+#define TIMER2_CS TIMER_CS2(TIMER2_PRESCALER)
+#define TIMER2_TICKS TIMER_TICKS(TIMER2_PERIOD_US, TIMER2_PRESCALER)
+#define TIMER2_OCR (TIMER2_TICKS - 1)
+#if TIMER2_MODE == TIMER_MODE_CTC
+	#define TIMER2_PERIOD_NS TIMER_PERIOD_NS(TIMER2_TICKS, TIMER2_PRESCALER)
+#else
+	#define TIMER2_PERIOD_NS TIMER_PERIOD_NS(256ULL, TIMER2_PRESCALER)
+#endif
+#define TIMER2_ERROR_PERMILLE TIMER_ERROR_PERMILLE(TIMER2_PERIOD_US, TIMER2_PERIOD_NS)
+
+/* checks, the range only matters for timers in use */
+#if TIMER0_MODE != TIMER_MODE_OFF
+	#if (TIMER0_TICKS < 1) || (TIMER0_TICKS > 256)
+		#error "TIMER_CFG: TIMER0_PERIOD_US is out of range at this F_CPU"
+	#endif
+	#if (TIMER0_MODE == TIMER_MODE_CTC) && (TIMER0_ERROR_PERMILLE > (TIMER_PERIOD_TOL * 10))
+		#error "TIMER_CFG: TIMER0_PERIOD_US can not be reached within TIMER_PERIOD_TOL"
+	#endif
+	#if TIMER0_MODE == TIMER_MODE_CAPTURE
+		#error "TIMER_CFG: only Timer1 has an input capture unit"
+	#endif
+#endif
+#if TIMER1_MODE != TIMER_MODE_OFF
+	#if (TIMER1_TICKS < 1) || (TIMER1_TICKS > 65536)
+		#error "TIMER_CFG: TIMER1_PERIOD_US is out of range at this F_CPU"
+	#endif
+	#if (TIMER1_MODE == TIMER_MODE_CTC) && (TIMER1_ERROR_PERMILLE > (TIMER_PERIOD_TOL * 10))
+		#error "TIMER_CFG: TIMER1_PERIOD_US can not be reached within TIMER_PERIOD_TOL"
+	#endif
+#endif
+#if TIMER2_MODE != TIMER_MODE_OFF
+	#if (TIMER2_TICKS < 1) || (TIMER2_TICKS > 256)
+		#error "TIMER_CFG: TIMER2_PERIOD_US is out of range at this F_CPU"
+	#endif
+	#if (TIMER2_MODE == TIMER_MODE_CTC) && (TIMER2_ERROR_PERMILLE > (TIMER_PERIOD_TOL * 10))
+		#error "TIMER_CFG: TIMER2_PERIOD_US can not be reached within TIMER_PERIOD_TOL"
+	#endif
+	#if TIMER2_MODE == TIMER_MODE_CAPTURE
+		#error "TIMER_CFG: only Timer1 has an input capture unit"
+	#endif
+#endif
+
+/* the same checks in C, the compiler evaluates the macros in their own
+ * types. They fail if C and the preprocessor disagree, e.g. after an 
+ * overflow in 32 bit */
+#define TIMER_C_CHECK(ticks, max, ctc, permille) \
+	(((ticks) >= 1) && ((ticks) <= (max)) && (!(ctc) || ((permille) <= (TIMER_PERIOD_TOL * 10))))
+#if TIMER0_MODE != TIMER_MODE_OFF
+	_Static_assert(TIMER_C_CHECK(TIMER0_TICKS, 256, TIMER0_MODE == TIMER_MODE_CTC,
+		TIMER0_ERROR_PERMILLE), "TIMER_CFG: TIMER0 differs between C and the preprocessor");
+#endif
+#if TIMER1_MODE != TIMER_MODE_OFF
+	_Static_assert(TIMER_C_CHECK(TIMER1_TICKS, 65536, TIMER1_MODE == TIMER_MODE_CTC,
+		TIMER1_ERROR_PERMILLE), "TIMER_CFG: TIMER1 differs between C and the preprocessor");
+#endif
+#if TIMER2_MODE != TIMER_MODE_OFF
+	_Static_assert(TIMER_C_CHECK(TIMER2_TICKS, 256, TIMER2_MODE == TIMER_MODE_CTC,
+		TIMER2_ERROR_PERMILLE), "TIMER_CFG: TIMER2 differs between C and the preprocessor");
+#endif
+
+#endif
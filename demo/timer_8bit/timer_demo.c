@@ -11,14 +11,25 @@
  * Changelog:
  * [Date][Author]:[Change]
  * [15.09.2019][nmt]: initial commit
+ * [17.10.2026][nmt]: simavr support, see the sim target
+ * [17.10.2026][nmt]: timers are set up by the timer driver, Timer2
+ *										toggles pin B2
+ * [17.10.2026][nmt]: Timer0 runs the system tick, the LED blinks 
+ *										without _delay_ms
+ * [17.10.2026][nmt]: the LED is blinked by the timer wheel, pin B3 
+ *										shows a one-shot timeout
  *********************************************************************/
 
 /*********************************************************************
  * Usage: 
  *
- * Connect an LED to pin B1 on the arduino, that way you can see 
- * when a timer interrupt occurs. The LED will blink pretty fast
- * though because it is only an 8-bit timer.
+ * Connect an LED to pin B1 on the arduino, it blinks once per 
+ * second. Timer0 is the 1 ms system tick and drives the timer wheel,
+ * a periodic timer of the wheel toggles the LED. Every blink starts a
+ * one-shot timeout of 100 ms that sets pin B3 low again after the 
+ * LED callback set it high. Pin B2 is toggled by Timer2 every 10 ms, 
+ * use a scope or the VCD file of "make sim". The period of Timer2 is 
+ * set in timer_cfg.h.
  *********************************************************************/
 
 /*********************************************************************
@@ -26,7 +37,10 @@
  *********************************************************************/
 #include <avr/io.h> 
 #include <avr/interrupt.h>
-#include <util/delay.h>
+
+#include "timer.h"
+#include "systick.h"
+#include "wheel.h"
 
 /*********************************************************************
  * MACROS
@@ -36,23 +50,51 @@
 	#define F_CPU 4000000UL
 #endif
 
-#define COUNTER_COMPARE_VALUE	0xff
+/* NOTE: only used for "make sim", tells simavr which MCU and clock to
+ * use and which registers to record in timer_8bit.vcd */
+#ifdef SIMAVR
+#include "avr_mcu_section.h"
+AVR_MCU(F_CPU, "atmega328p");
+AVR_MCU_VCD_FILE("timer_8bit.vcd", 1000);
+const struct avr_mmcu_vcd_trace_t simavr_trace[] _MMCU_ = {
+	{ AVR_MCU_VCD_SYMBOL("PB1"), .mask = (1 << PB1), .what = (void*)&PORTB, },
+	{ AVR_MCU_VCD_SYMBOL("PB2"), .mask = (1 << PB2), .what = (void*)&PORTB, },
+	{ AVR_MCU_VCD_SYMBOL("PB3"), .mask = (1 << PB3), .what = (void*)&PORTB, },
+};
+#endif
+
+/* the LED changes its state every 500 ms */
+#define LED_PERIOD_MS 500
+
+/* pin B3 is high for this time after each LED change */
+#define PULSE_MS 100
+
+#if SYSTICK_WHEEL == 0
+	#error "TIMER_DEMO: the demo needs SYSTICK_WHEEL, see the Makefile"
+#endif
 
 /*********************************************************************
  * FUNCTION PROTOTYPES
  *********************************************************************/ 
 /**
- * @brief sets up the pin B1 to connect an LED
+ * @brief sets up the pin B1 to connect an LED and pins B2 and B3
  * @return void
  */
 void gpio_setup(void);
 
 /**
- * @brief sets up the timer
- * @param comp_value the value to compare the counter value of the timer to
+ * @brief periodic timer, toggles the LED and starts the pulse on B3
+ * @param id timer
+ * @return void
+ */
+void led_toggle(uint8_t id);
+
+/**
+ * @brief one-shot timer, ends the pulse on B3
+ * @param id timer
  * @return void
  */
-void timer_setup(uint8_t comp_value);
+void pulse_end(uint8_t id);
 
 /*********************************************************************
  * MAIN FUNCTION
@@ -61,15 +103,23 @@ int main(void) {
 
 	/* initialize peripherals */
 	gpio_setup();
-	timer_setup(COUNTER_COMPARE_VALUE);
+	/* Timer2 in CTC mode, see timer_cfg.h */
+	timer_init();
+	/* the wheel before its tick */
+	wheel_init();
+	wheel_start(LED_PERIOD_MS, LED_PERIOD_MS, led_toggle);
+	/* Timer0 as the 1 ms tick */
+	systick_init();
 
 	/* global interrupt enable */
   sei();        
 
     while (1) {
 
-			PINB &= ~(1 << PB1);
-			_delay_ms(1000);
+			/* the callbacks of the wheel run here */
+			wheel_run();
+
+			/* the CPU is free for other work here */
 
     }
 }
@@ -77,10 +127,12 @@ int main(void) {
 /*********************************************************************
  * INTERRUPT SERVICE ROUTINE
  *********************************************************************/ 
-/* ISR triggered on timer0 compare match */
-ISR (TIMER0_COMPA_vect) {
-	/* set the pin to high */
-	PINB |= (1 << PINB1);
+/* NOTE: the ISR of Timer0 is in systick.c */
+
+/* ISR triggered on timer2 compare match */
+ISR (TIMER2_COMPA_vect) {
+	/* toggle pin B2 */
+	PINB = (1 << PINB2);
 }
 
 /*********************************************************************
@@ -90,37 +142,19 @@ void gpio_setup() {
 
 	/* gpio setup */
 
-	/* pin B1 to output */
-	DDRB = (1 << DDB1);
+	/* pin B1, B2 and B3 to output */
+	DDRB = (1 << DDB1) | (1 << DDB2) | (1 << DDB3);
 	/* set the pin to low */
 	PINB &= ~(1 << PINB1);
 
 }
 
-void timer_setup(uint8_t comp_value) {
-
-	/* timer setup */
-
-	/* NOTE: check out datasheet section 14 for more details */
-
-	/* NOTE:	This is the "Clear Timer on Compare Match (CTC) Mode" 
-						basically you set a value in OCR0A and the timer value 
-						is continuously compared to this value. Once it matches
-						the counter of the timer is cleared. When this happens
-						you can trigger an interrupt, which is exactly what we
-						are setting up below. To change what happens when an 
-						interrupt occurs add your code to the ISR above. */
-	
-	/* set CTC mode */
-	TCCR0A |= (1 << WGM01);
-	/* set value to count to */
-	OCR0A = comp_value;
-	/* enable the timer/counter0 compare match A interrupt */
-	TIMSK0 |= (1 << OCIE0A);
-	/* set the prescaler to 1024, resulting in a slower timer 
-	   so we can actually see the led blinking */
-	TCCR0B |= ((1 << CS00) | (1 << CS02));
-  
+void led_toggle(uint8_t id) {
+	PINB = (1 << PINB1);
+	PORTB |= (1 << PORTB3);
+	wheel_start(PULSE_MS, 0, pulse_end);
 }
 
-
+void pulse_end(uint8_t id) {
+	PORTB &= ~(1 << PORTB3);
+}
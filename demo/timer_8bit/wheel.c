@@ -0,0 +1,290 @@
+/*********************************************************************
+ * Timer Wheel - C File
+ * Short Name: wheel
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: many software timers on one hardware tick, one-shot
+ *							and periodic
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <stddef.h>
+
+#include "wheel.h"
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* NOTE: the links are circular lists with a head of their own, the
+ * heads of the slots and of the expired list follow the timers in the
+ * link arrays. A timer is removed without knowing its list and a whole
+ * slot moves in four steps. */
+#define WHEEL_SLOT(level, index) (WHEEL_TIMERS + ((level) * WHEEL_SLOTS) + (index))
+#define WHEEL_EXPIRED (WHEEL_LINKS - 1)
+
+/* end of the list of free timers */
+#define WHEEL_NONE 0xff
+
+/*********************************************************************
+ * VARIABLES
+ *********************************************************************/
+/* links of the timers and list heads */
+static uint8_t link_next[WHEEL_LINKS];
+static uint8_t link_prev[WHEEL_LINKS];
+
+/* the timers, a free timer has no callback */
+static uint16_t timer_expires[WHEEL_TIMERS];
+static uint16_t timer_period[WHEEL_TIMERS];
+static wheel_callback_t timer_callback[WHEEL_TIMERS];
+
+/* free timers, linked through link_next */
+static uint8_t free_head = WHEEL_NONE;
+
+/* ticks since wheel_init, only written by the ISR */
+static volatile uint16_t wheel_now = 0;
+
+/*********************************************************************
+ * LOCAL FUNCTION PROTOTYPES
+ *********************************************************************/
+
+/**
+ * @brief removes an element from its list
+ * @param id timer
+ * @return void
+ */
+static void wheel_unlink(uint8_t id);
+
+/**
+ * @brief appends an element to a list
+ * @param head list head
+ * @param id timer
+ * @return void
+ */
+static void wheel_append(uint8_t head, uint8_t id);
+
+/**
+ * @brief moves all elements of a list to the end of another one
+ * @param to list head
+ * @param from list head, empty afterwards
+ * @return void
+ */
+static void wheel_splice(uint8_t to, uint8_t from);
+
+/**
+ * @brief puts a timer into the slot of its expiry time
+ * NOTE: interrupts have to be disabled
+ * @param id timer
+ * @return void
+ */
+static void wheel_insert(uint8_t id);
+
+/**
+ * @brief sorts the timers of a slot into the lower levels
+ * @param level level of the slot, at least 1
+ * @param index slot
+ * @return void
+ */
+static void wheel_cascade(uint8_t level, uint8_t index);
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+void wheel_init(void) {
+
+	uint8_t i = 0;
+
+	/* an empty list points to its own head */
+	for(i = WHEEL_TIMERS; i < WHEEL_LINKS; i++) {
+		link_next[i] = i;
+		link_prev[i] = i;
+	}
+	/* all timers are free */
+	for(i = 0; i < WHEEL_TIMERS; i++) {
+		timer_callback[i] = NULL;
+		link_next[i] = (i + 1 < WHEEL_TIMERS) ? (i + 1) : WHEEL_NONE;
+	}
+	free_head = 0;
+	wheel_now = 0;
+}
+
+uint8_t wheel_start(uint16_t delay, uint16_t period, wheel_callback_t callback) {
+
+	uint8_t sreg = SREG;
+	uint8_t id = WHEEL_INVALID;
+
+	if((callback == NULL) || (delay > WHEEL_MAX_TICKS) || (period > WHEEL_MAX_TICKS)) {
+		return WHEEL_INVALID;
+	}
+
+	cli();
+	if(free_head != WHEEL_NONE) {
+		id = free_head;
+		free_head = link_next[id];
+		timer_callback[id] = callback;
+		timer_period[id] = period;
+		timer_expires[id] = wheel_now + delay;
+		wheel_insert(id);
+	}
+	SREG = sreg;
+
+	return id;
+}
+
+uint8_t wheel_cancel(uint8_t id) {
+
+	uint8_t sreg = SREG;
+	uint8_t status = 1;
+
+	if(id >= WHEEL_TIMERS) {
+		return 1;
+	}
+
+	cli();
+	if(timer_callback[id] != NULL) {
+		wheel_unlink(id);
+		timer_callback[id] = NULL;
+		link_next[id] = free_head;
+		free_head = id;
+		status = 0;
+	}
+	SREG = sreg;
+
+	return status;
+}
+
+void wheel_tick(void) {
+
+	uint16_t now = ++wheel_now;
+	uint8_t level = 0;
+	uint8_t index = (uint8_t)now & WHEEL_SLOT_MASK;
+
+	/* when a level starts over, the next slot of the level above is
+	 * due, this runs once every WHEEL_SLOTS ticks for level 1 */
+	for(level = 1; (level < WHEEL_LEVELS) && (index == 0); level++) {
+		index = (uint8_t)(now >> (level * WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK;
+		wheel_cascade(level, index);
+	}
+
+	/* everything in the current slot expires now */
+	wheel_splice(WHEEL_EXPIRED, WHEEL_SLOT(0, (uint8_t)now & WHEEL_SLOT_MASK));
+}
+
+uint8_t wheel_run(void) {
+
+	uint8_t sreg = SREG;
+	uint8_t count = 0;
+	uint8_t id = 0;
+	wheel_callback_t callback = NULL;
+
+	while(1) {
+		cli();
+		id = link_next[WHEEL_EXPIRED];
+		if(id == WHEEL_EXPIRED) {
+			SREG = sreg;
+			break;
+		}
+		wheel_unlink(id);
+		callback = timer_callback[id];
+		if(timer_period[id]) {
+			/* stays on its grid, periods missed by a late wheel_run
+			 * are skipped */
+			do {
+				timer_expires[id] += timer_period[id];
+			} while((int16_t)(timer_expires[id] - wheel_now) <= 0);
+			wheel_insert(id);
+		} else {
+			timer_callback[id] = NULL;
+			link_next[id] = free_head;
+			free_head = id;
+		}
+		SREG = sreg;
+
+		callback(id);
+		count++;
+	}
+
+	return count;
+}
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ *********************************************************************/
+static void wheel_unlink(uint8_t id) {
+	link_next[link_prev[id]] = link_next[id];
+	link_prev[link_next[id]] = link_prev[id];
+}
+
+static void wheel_append(uint8_t head, uint8_t id) {
+	link_prev[id] = link_prev[head];
+	link_next[id] = head;
+	link_next[link_prev[head]] = id;
+	link_prev[head] = id;
+}
+
+static void wheel_splice(uint8_t to, uint8_t from) {
+
+	uint8_t first = link_next[from];
+	uint8_t last = link_prev[from];
+
+	if(first == from) {
+		return;
+	}
+	link_next[link_prev[to]] = first;
+	link_prev[first] = link_prev[to];
+	link_next[last] = to;
+	link_prev[to] = last;
+	link_next[from] = from;
+	link_prev[from] = from;
+}
+
+static void wheel_insert(uint8_t id) {
+
+	uint16_t expires = timer_expires[id];
+	uint16_t delta = expires - wheel_now;
+	uint8_t level = 0;
+
+	/* due or overdue, the current slot was already moved */
+	if((int16_t)delta <= 0) {
+		wheel_append(WHEEL_EXPIRED, id);
+		return;
+	}
+	/* the lowest level whose span holds the delay, then the slot of
+	 * the expiry time on that level */
+	while((level < (WHEEL_LEVELS - 1)) && (delta >= (1U << ((level + 1) * WHEEL_SLOT_BITS)))) {
+		level++;
+	}
+	wheel_append(WHEEL_SLOT(level, (uint8_t)(expires >> (level * WHEEL_SLOT_BITS)) & WHEEL_SLOT_MASK), id);
+}
+
+static void wheel_cascade(uint8_t level, uint8_t index) {
+
+	uint8_t head = WHEEL_SLOT(level, index);
+	uint8_t id = link_next[head];
+	uint8_t next = 0;
+
+	/* take the whole list first, a timer could go back into a slot
+	 * with the same head otherwise */
+	link_next[link_prev[head]] = WHEEL_NONE;
+	link_next[head] = head;
+	link_prev[head] = head;
+
+	while((id != head) && (id != WHEEL_NONE)) {
+		next = link_next[id];
+		wheel_insert(id);
+		id = next;
+	}
+}
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
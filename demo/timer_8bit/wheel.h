@@ -0,0 +1,108 @@
+/*********************************************************************
+ * Timer Wheel - Header File
+ * Short Name: wheel
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: many software timers on one hardware tick, one-shot
+ *							and periodic
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * NOTES:	The timers are kept in a hierarchical wheel, see
+ *				wheel_cfg.h. Each slot is a doubly linked list, so starting
+ *				and cancelling a timer is a constant number of steps no
+ *				matter how many timers run. The timers come from a static
+ *				pool, there is no malloc.
+ *
+ *				wheel_tick has to be called from the ISR of the hardware
+ *				tick, e.g. the system tick with SYSTICK_WHEEL set to 1. It
+ *				only moves the list of the current slot to the expired
+ *				list. Every WHEEL_SLOTS ticks the current slot of the next
+ *				level is sorted into the lower levels, this is the only
+ *				step that depends on the number of timers in that slot.
+ *				The callbacks run in wheel_run, called from the main loop,
+ *				so they may take their time and use all drivers.
+ *
+ *				void led(uint8_t id) { PINB = (1 << PINB1); }
+ *				wheel_start(500, 500, led);
+ *				while(1) { wheel_run(); }
+ *********************************************************************/
+
+#ifndef WHEEL_H
+#define WHEEL_H
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <stdint.h>
+
+#include "wheel_cfg.h"
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* returned by wheel_start if no timer is left */
+#define WHEEL_INVALID 0xff
+
+/*********************************************************************
+ * TYPES
+ *********************************************************************/
+/* called from wheel_run with the id of the expired timer */
+typedef void (*wheel_callback_t)(uint8_t id);
+
+/*********************************************************************
+ * FUNCTION PROTOTYPES
+ *********************************************************************/
+
+/**
+ * @brief empties all slots and fills the pool, call before the tick
+ * interrupt is enabled
+ * @return void
+ */
+void wheel_init(void);
+
+/**
+ * @brief starts a timer
+ * @param delay ticks until the first expiry, 0 expires in the next
+ * wheel_run, at most WHEEL_MAX_TICKS
+ * @param period ticks between the following expiries, 0 for a
+ * one-shot timer, at most WHEEL_MAX_TICKS
+ * @param callback called from wheel_run on expiry
+ * @return id of the timer or WHEEL_INVALID if the pool is empty or
+ * an argument is out of range
+ */
+uint8_t wheel_start(uint16_t delay, uint16_t period, wheel_callback_t callback);
+
+/**
+ * @brief stops a timer and returns it to the pool, also if it expired
+ * and wheel_run did not call it yet
+ * NOTE: a one-shot timer is returned to the pool before its callback
+ * runs, its id is invalid from then on
+ * @param id id returned by wheel_start
+ * @return 0 on success, 1 if the timer is not running
+ */
+uint8_t wheel_cancel(uint8_t id);
+
+/**
+ * @brief advances the wheel by one tick, call from the tick ISR
+ * @return void
+ */
+void wheel_tick(void);
+
+/**
+ * @brief calls the callbacks of all expired timers and restarts the
+ * periodic ones, call from the main loop
+ * @return number of callbacks
+ */
+uint8_t wheel_run(void);
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
+#endif
@@ -0,0 +1,58 @@
+/*********************************************************************
+ * Timer Wheel - Configuration File
+ * Short Name: wheel_cfg
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: Settings for the timer wheel, number of timers, levels
+ *							and slots
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+#ifndef WHEEL_CFG_H
+#define WHEEL_CFG_H
+
+/*********************************************************************
+ * SETTINGS
+ *********************************************************************/
+/* number of timers in the pool, a timer uses 8 bytes of SRAM */
+#define WHEEL_TIMERS 16
+
+/* NOTE: level 0 has one slot per tick, every slot of level n covers
+ * all slots of level n-1. With 3 levels of 32 slots a timer can run
+ * up to 32767 ticks, at a 1 ms tick about 32 seconds. A slot uses 2
+ * bytes of SRAM. */
+#define WHEEL_LEVELS 3
+#define WHEEL_SLOT_BITS 5
+
+/*********************************************************************
+ * DERIVED VALUES
+ *********************************************************************/
+#define WHEEL_SLOTS (1U << WHEEL_SLOT_BITS)
+#define WHEEL_SLOT_MASK (WHEEL_SLOTS - 1)
+/* longest delay in ticks */
+#define WHEEL_MAX_TICKS ((1UL << (WHEEL_LEVELS * WHEEL_SLOT_BITS)) - 1)
+
+/* the links are 8 bit indices, timers, slots and the list of expired
+ * timers share them */
+#define WHEEL_LINKS (WHEEL_TIMERS + (WHEEL_LEVELS * WHEEL_SLOTS) + 1)
+
+#if (WHEEL_TIMERS < 1) || (WHEEL_TIMERS > 64)
+	#error "WHEEL_CFG: WHEEL_TIMERS must be in [1 - 64]"
+#endif
+#if (WHEEL_LEVELS < 1) || (WHEEL_SLOT_BITS < 1)
+	#error "WHEEL_CFG: WHEEL_LEVELS and WHEEL_SLOT_BITS must be at least 1"
+#endif
+/* the tick counter is 16 bit, a delay has to fit into half of it */
+#if (WHEEL_LEVELS * WHEEL_SLOT_BITS) > 15
+	#error "WHEEL_CFG: WHEEL_LEVELS * WHEEL_SLOT_BITS must not exceed 15"
+#endif
+#if WHEEL_LINKS > 255
+	#error "WHEEL_CFG: too many slots and timers, reduce WHEEL_SLOT_BITS or WHEEL_TIMERS"
+#endif
+
+#endif
@@ -0,0 +1,89 @@
+/*********************************************************************
+ * Framed Streaming Protocol - C File
+ * Short Name: frame
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: binary frames with SLIP framing and CRC-16 for 
+ *							streaming sensor data over the UART
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <util/crc16.h>
+
+#include "frame.h"
+#include "uart.h"
+
+/*********************************************************************
+ * VARIABLES
+ *********************************************************************/
+/* sequence number of the next frame */
+static uint8_t frame_seq = 0;
+/* CRC of the frame that is being sent */
+static uint16_t frame_crc = 0;
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+/* adds a byte to the CRC and sends it SLIP encoded */
+static void frame_byte(uint8_t data) {
+
+	frame_crc = _crc_xmodem_update(frame_crc, data);
+
+	if(data == FRAME_END) {
+		uart_send(FRAME_ESC);
+		uart_send(FRAME_ESC_END);
+	} else if(data == FRAME_ESC) {
+		uart_send(FRAME_ESC);
+		uart_send(FRAME_ESC_ESC);
+	} else {
+		uart_send(data);
+	}
+}
+
+void frame_begin(uint8_t type, uint16_t timestamp) {
+
+	/* an end marker in front of the frame flushes any noise the 
+	 * receiver collected in the meantime */
+	uart_send(FRAME_END);
+
+	frame_crc = 0;
+	frame_byte(type);
+	frame_byte(frame_seq++);
+	frame_byte((uint8_t)timestamp);
+	frame_byte((uint8_t)(timestamp >> 8));
+}
+
+void frame_put(const uint8_t *data, uint8_t len) {
+	while(len) {
+		frame_byte(*data++);
+		len--;
+	}
+}
+
+void frame_end(void) {
+
+	/* frame_byte changes the CRC, so keep a copy */
+	uint16_t crc = frame_crc;
+
+	frame_byte((uint8_t)crc);
+	frame_byte((uint8_t)(crc >> 8));
+	uart_send(FRAME_END);
+}
+
+void frame_send(uint8_t type, uint16_t timestamp, const uint8_t *data, uint8_t len) {
+	frame_begin(type, timestamp);
+	frame_put(data, len);
+	frame_end();
+}
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
@@ -0,0 +1,114 @@
+/*********************************************************************
+ * Framed Streaming Protocol - Header File
+ * Short Name: frame
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: binary frames with SLIP framing and CRC-16 for 
+ *							streaming sensor data over the UART
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ * [17.10.2026][nmt]: task run time frames
+ *********************************************************************/
+
+/*********************************************************************
+ * NOTES:
+ * Frame layout before SLIP encoding:
+ *
+ *	[type][seq][timestamp low][timestamp high][payload ...][crc low][crc high]
+ *
+ * type:			one of FRAME_TYPES
+ * seq:				incremented for every frame, the receiver counts gaps 
+ *						as dropped frames
+ * timestamp:	16 bit, chosen by the sender, little endian
+ * payload:		0 or more bytes, sensor values are forwarded in the 
+ *						byte order of the sensor (big endian)
+ * crc:				CRC-16/XMODEM (polynomial 0x1021, initial value 0) 
+ *						over type, seq, timestamp and payload, little endian
+ *
+ * SLIP (RFC 1055): every frame starts and ends with FRAME_END. A data
+ * byte equal to FRAME_END is sent as FRAME_ESC FRAME_ESC_END, a data
+ * byte equal to FRAME_ESC as FRAME_ESC FRAME_ESC_ESC. Unlike COBS, 
+ * SLIP needs no look ahead, so every byte goes straight into the UART
+ * transmit buffer without copying the frame first.
+ *
+ * The host side decoder is in tools/frame_decode.
+ *********************************************************************/
+
+#ifndef FRAME_H
+#define FRAME_H
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <stdint.h>
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* SLIP special characters */
+#define FRAME_END			0xc0
+#define FRAME_ESC			0xdb
+#define FRAME_ESC_END	0xdc
+#define FRAME_ESC_ESC	0xdd
+
+/*********************************************************************
+ * TYPES
+ *********************************************************************/
+/* message types */
+enum FRAME_TYPES {
+	FRAME_TYPE_STATUS = 0x01,		/* payload: one status byte */
+	FRAME_TYPE_ERROR = 0x02,		/* payload: one error code */
+	FRAME_TYPE_SAMPLE = 0x03,		/* payload: 14 byte MPU6050 sample */
+	FRAME_TYPE_ACC = 0x04,			/* payload: n * accelerometer x/y/z */
+	FRAME_TYPE_TASKS = 0x05			/* payload: n * worst case run time of
+															 * a task in us, 16 bit little endian */
+};
+
+/*********************************************************************
+ * FUNCTION PROTOTYPES
+ *********************************************************************/
+
+/* NOTE: the frame functions use the blocking uart_send, they only 
+ * wait if the transmit ring buffer is full. Frames must not be built
+ * from interrupts and the main loop at the same time. */
+
+/**
+ * @brief starts a new frame and sends its header
+ * @param type message type, see FRAME_TYPES
+ * @param timestamp timestamp of the frame
+ * @return void
+ */
+void frame_begin(uint8_t type, uint16_t timestamp);
+
+/**
+ * @brief appends payload to the frame started with frame_begin
+ * @param data payload bytes
+ * @param len number of payload bytes
+ * @return void
+ */
+void frame_put(const uint8_t *data, uint8_t len);
+
+/**
+ * @brief finishes the frame by sending the CRC and the end marker
+ * @return void
+ */
+void frame_end(void);
+
+/**
+ * @brief sends a complete frame
+ * @param type message type, see FRAME_TYPES
+ * @param timestamp timestamp of the frame
+ * @param data payload bytes
+ * @param len number of payload bytes
+ * @return void
+ */
+void frame_send(uint8_t type, uint16_t timestamp, const uint8_t *data, uint8_t len);
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
+#endif
@@ -11,6 +11,17 @@
  * Changelog:
  * [Date][Author]:[Change]
  * [19.09.2019][nmt]: initial commit
+ * [17.10.2026][nmt]: enable interrupts for the interrupt driven UART
+ * [17.10.2026][nmt]: read all sensor values in one burst
+ * [17.10.2026][nmt]: FIFO based sampling at 1 kHz
+ * [17.10.2026][nmt]: data ready interrupt mode with sleep
+ * [17.10.2026][nmt]: framed binary protocol instead of raw bytes
+ * [17.10.2026][nmt]: 1 ms tick for the TWI timeouts
+ * [17.10.2026][nmt]: simavr support, see the sim target
+ * [17.10.2026][nmt]: the superloop is replaced by scheduler tasks
+ * [17.10.2026][nmt]: removed the single byte read, replaced by the burst
+ * [17.10.2026][nmt]: bus clear after a TWI timeout in a task
+ * [17.10.2026][nmt]: DRDY_MODE checks the baudrate it needs
  *********************************************************************/
 
 /*********************************************************************
@@ -18,18 +29,37 @@
  *					Connect	the MPU6050 sensor to the arduino, AD0 is not set in 
  *					this example, so the I2C address of the MPU6050 is 0x68.
  *					Please note that this program sends the raw sensor values
- *					over the UART.
+ *					over the UART in binary frames, see frame.h. Use 
+ *					tools/frame_decode on the host to read them.
+ *					Once per second a FRAME_TYPE_TASKS frame reports the worst 
+ *					case run time of every task in microseconds.
  *********************************************************************/
 
 /*********************************************************************
  * LIBRARIES
  *********************************************************************/
 #include <avr/io.h>
-#include <util/delay.h>
+#include <avr/interrupt.h>
 #include <util/twi.h>
 
 #include "uart.h"
 #include "twi.h"
+#include "mpu6050.h"
+#include "frame.h"
+#include "sched.h"
+
+/* NOTE: only used for "make sim", tells simavr which MCU and clock to
+ * use and which registers to record in twi.vcd */
+#ifdef SIMAVR
+#include "avr_mcu_section.h"
+AVR_MCU(F_CPU, "atmega328p");
+AVR_MCU_VCD_FILE("twi.vcd", 1000);
+const struct avr_mmcu_vcd_trace_t simavr_trace[] _MMCU_ = {
+	{ AVR_MCU_VCD_SYMBOL("UDR0"), .mask = 0xff, .what = (void*)&UDR0, },
+	{ AVR_MCU_VCD_SYMBOL("TWDR"), .mask = 0xff, .what = (void*)&TWDR, },
+	{ AVR_MCU_VCD_SYMBOL("TWSR"), .mask = 0xf8, .what = (void*)&TWSR, },
+};
+#endif
 
 /*********************************************************************
  * MACROS
@@ -41,11 +71,43 @@
 /* relevant register address of the MPU6050 for this program */
 #define MPU6050_ADDR 0b11010000 /* 7-bit I2C address (110 1000 = 0x68)+ write bit */
 #define MPU6050_POWER_REGISTER 0x6b
-#define MPU6050_ACC_Z_HIGH_REGISTER 0x3f
-#define MPU6050_ACC_Z_LOW_REGISTER 0x40
 
-/* delay between sensor readings in ms */
-#define READ_DELAY 100
+/* time between sensor readings in ms */
+#define READ_PERIOD 100
+
+/* time between two run time reports in ms */
+#define REPORT_PERIOD 1000
+
+/* set by the data ready notification */
+#define EVENT_SAMPLE SCHED_EVENT(0)
+
+/* uncomment to let the sensor sample at 1 kHz into its FIFO and read
+ * the samples in bursts instead of reading single values
+ * NOTE: every sample sends at least 6 bytes, at 1 kHz the UART needs
+ * at least 76800 baud to keep up, see BAUDRATE in uart_cfg.h */
+/* #define FIFO_MODE 1 */
+
+/* uncomment to read a complete sample as soon as the sensor signals
+ * new data on INT0, connect the INT pin of the MPU6050 to pin D2. The
+ * CPU sleeps while waiting.
+ * NOTE: 100 samples per second of up to 25 bytes each need at least
+ * 38400 baud, set BAUDRATE in uart_cfg.h or the Makefile, at the 
+ * default of 9600 frame_send would block on the full ring buffer */
+/* #define DRDY_MODE 1 */
+
+#if defined(DRDY_MODE) && (BAUDRATE < 38400)
+	#error "TWI_DEMO: DRDY_MODE needs a BAUDRATE of at least 38400"
+#endif
+
+/* Timer2 compare value for a 1 ms tick at prescaler 64 */
+#define TICK_COMPARE_VALUE ((F_CPU / 64UL / 1000UL) - 1)
+
+/* time between draining the sensor FIFO in ms, the ring buffer 
+ * must hold all samples of this period */
+#define FIFO_DRAIN_PERIOD 10
+
+/* time between two checks for a pending TWI bus clear in ms */
+#define TWI_SERVICE_PERIOD 10
 
 /*********************************************************************
  * TYPES
@@ -58,29 +120,84 @@ enum TWI_STATUS_CODES {
 	FAILURE_TW_MT_DATA_ACK,
 	FAILURE_TW_REP_START,
 	FAILURE_TW_MR_SLA_ACK,
-	FAILURE_TW_MR_DATA_NACK	
+	FAILURE_TW_MR_DATA_NACK,
+	FAILURE_TW_BURST_READ,
+	FAILURE_TW_BUS_STUCK
 };
 
-/* states for the main state machine to read the MPU6050 and send
-   the measured values over the UART */
-enum MAIN_FSM_STATES {
-	STATE_WAIT,
-	STATE_TWI_READ_HIGH,
-	STATE_TWI_READ_LOW,
-	STATE_UART_SEND_HIGH,
-	STATE_UART_SEND_LOW,
-	STATE_UART_SEND_NEWLINE,
-	STATE_ERROR
-};
 
+/*********************************************************************
+ * VARIABLES
+ *********************************************************************/
+/* timestamp for the frames, counts the samples */
+static uint16_t timestamp = 0;
 
 /*********************************************************************
  * FUNCTION PROTOTYPES
  *********************************************************************/
 
-/* NOTE: these functions send error codes using the UART if an
+/* NOTE: these functions send error codes in error frames if an
 				 error occurs. */
 
+/**
+ * @brief sends an error frame
+ * @param error_code see TWI_STATUS_CODES
+ * @return void
+ */
+static void send_error(uint8_t error_code);
+
+/**
+ * @brief sets up Timer2 for a 1 ms tick, drives the TWI timeouts and 
+ * the scheduler
+ * @return void
+ */
+static void tick_setup(void);
+
+/* the tasks, see sched.h */
+
+/**
+ * @brief reads a sample and sends it, every READ_PERIOD
+ * @param events unused
+ * @return void
+ */
+static void task_sample(uint8_t events);
+
+/**
+ * @brief drains the FIFO and sends the samples, every FIFO_DRAIN_PERIOD
+ * @param events unused
+ * @return void
+ */
+static void task_fifo(uint8_t events);
+
+/**
+ * @brief sends the sample of the data ready mode, on EVENT_SAMPLE
+ * @param events EVENT_SAMPLE
+ * @return void
+ */
+static void task_drdy(uint8_t events);
+
+/**
+ * @brief clears the TWI bus after a timeout of the engine, every
+ * TWI_SERVICE_PERIOD
+ * @param events unused
+ * @return void
+ */
+static void task_twi(uint8_t events);
+
+/**
+ * @brief sends the worst case run time of all tasks, every 
+ * REPORT_PERIOD
+ * @param events unused
+ * @return void
+ */
+static void task_report(uint8_t events);
+
+/**
+ * @brief called from the TWI interrupt when a data ready sample is in
+ * @return void
+ */
+static void drdy_notify(void);
+
 /**
  * @brief wakes up the MPU6050
  * @return OK on success, error code otherwise
@@ -88,12 +205,12 @@ enum MAIN_FSM_STATES {
 uint8_t MPU6050_wakeup();
 
 /**
- * @brief reads a single byte from the MPU6050
- * @param data stores the data that was read
- * @param addr register address to read from
+ * @brief reads accelerometer, temperature and gyroscope in one burst
+ * NOTE: all values belong to the same sample, unlike single reads
+ * @param sample storage for MPU6050_SAMPLE_SIZE bytes
  * @return OK on success, error code otherwise
  */
-uint8_t MPU6050_read(uint8_t *data, uint8_t addr);
+uint8_t MPU6050_read_sample(uint8_t *sample);
 
 
 /*********************************************************************
@@ -101,77 +218,54 @@ uint8_t MPU6050_read(uint8_t *data, uint8_t addr);
  *********************************************************************/
 void main() {
 
-	/* state variable for the main state machine */
-	uint8_t main_state = STATE_WAIT;
-
-	/* store accelerometer values */
-	uint8_t acc_z_high = 0x00;
-	uint8_t acc_z_low = 0x00;
-	/* newline character for UART */
-	uint8_t newline = '\n';
+	/* status reported after the wake up */
+	uint8_t wakeup_status = MPU6050_WAKEUP_SUCCESS;
 
 	/* initialize UART and TWI */
 	twi_init();
 	uart_init();
+	tick_setup();
+	/* the interrupt driven UART needs global interrupts */
+	sei();
 
 	/* power on the MPU6050 */
 	if(MPU6050_wakeup() == OK) {
-		/* send zero over the UART to indicate that the MPU6050 is activated */
-		uart_send(MPU6050_WAKEUP_SUCCESS);
+		/* send a status frame to indicate that the MPU6050 is activated */
+		frame_send(FRAME_TYPE_STATUS, timestamp, &wakeup_status, 1);
 	} else {
-		uart_send(MPU6050_WAKEUP_FAILURE);
+		wakeup_status = MPU6050_WAKEUP_FAILURE;
+		frame_send(FRAME_TYPE_STATUS, timestamp, &wakeup_status, 1);
 		/* if the MPU6050 can not be activated indicate and error using the UART 
 			 and loop forever */
 		while(1);
 	}
 
-	while(1) {
-
-		/* SUPERLOOP */
-
-		/* state machine for interaction with sensor and UART */
-		switch(main_state) {
-
-			case STATE_WAIT:							/* wait for READ_DELAY between sensor readings */
-																		_delay_ms(READ_DELAY);
-																		acc_z_high = 0x00;
-																		acc_z_low = 0x00;
-																		main_state = STATE_TWI_READ_HIGH;
-																		break;
-			case STATE_TWI_READ_HIGH:			/* read the accelerometer z-axis high byte */
-																		if(MPU6050_read(&acc_z_high, MPU6050_ACC_Z_HIGH_REGISTER)) {
-																			/* if an error occurs go into the error state */
-																			main_state = STATE_ERROR;
-																		}
-																		main_state = STATE_TWI_READ_LOW;
-																		break;
-			case STATE_TWI_READ_LOW:			/* read the accelerometer z-axis low byte */
-																		if(MPU6050_read(&acc_z_low, MPU6050_ACC_Z_LOW_REGISTER)) {
-																			/* if an error occurs go into the error state */
-																			main_state = STATE_ERROR;	
-																		}
-																		main_state = STATE_UART_SEND_HIGH;
-																		break;
-			case STATE_UART_SEND_HIGH:		/* send the high byte over the UART */
-																		uart_send(acc_z_high);
-																		main_state = STATE_UART_SEND_LOW;
-																		break;
-			case STATE_UART_SEND_LOW:			/* send the low byte over the UART */
-																		uart_send(acc_z_low);
-																		main_state = STATE_UART_SEND_NEWLINE;
-																		break;
-			case STATE_UART_SEND_NEWLINE:	/* send a newline over the UART */
-																		uart_send(newline);	
-																		main_state = STATE_WAIT;
-																		break;
-			case STATE_ERROR:							uart_send(newline);
-																		break;
-			default:											/* default state should never occur */
-																		main_state = STATE_ERROR;
-																		break;
-		}; /* switch case*/
-
-	} /* while(1) */
+	/* NOTE: the tasks added first have priority, the sensor comes 
+	 * before the report */
+#ifdef FIFO_MODE
+	if(mpu6050_fifo_init(MPU6050_DIVIDER_1KHZ)) {
+		send_error(FAILURE_TW_BURST_READ);
+		while(1);
+	}
+	sched_add_periodic(task_fifo, FIFO_DRAIN_PERIOD, 0);
+#elif defined(DRDY_MODE)
+	/* 100 Hz, about 25 bytes per sample need the 38400 baud checked
+	 * above */
+	if(mpu6050_drdy_init(MPU6050_DIVIDER_100HZ, drdy_notify)) {
+		send_error(FAILURE_TW_BURST_READ);
+		while(1);
+	}
+	sched_add_event(task_drdy, EVENT_SAMPLE);
+	/* the engine stops after a timeout until the bus is cleared */
+	sched_add_periodic(task_twi, TWI_SERVICE_PERIOD, 0);
+#else
+	sched_add_periodic(task_sample, READ_PERIOD, 0);
+#endif
+	/* half a period later, so it does not delay a sample */
+	sched_add_periodic(task_report, REPORT_PERIOD, REPORT_PERIOD / 2);
+
+	/* runs the tasks and sleeps in between, never returns */
+	sched_run();
 
 } /* main */
 
@@ -179,6 +273,99 @@ void main() {
  * FUNCTIONS
  *********************************************************************/
 
+static void send_error(uint8_t error_code) {
+	frame_send(FRAME_TYPE_ERROR, timestamp, &error_code, 1);
+}
+
+static void task_sample(uint8_t events) {
+
+	/* stores one complete sample of the sensor */
+	uint8_t sample[MPU6050_SAMPLE_SIZE];
+
+	/* read all sensor values in one transaction, on an error the 
+	 * error frame was already sent, the timestamp still advances so 
+	 * the host sees the missing sample */
+	if(!MPU6050_read_sample(&sample[0])) {
+		frame_send(FRAME_TYPE_SAMPLE, timestamp, &sample[0], MPU6050_SAMPLE_SIZE);
+	}
+	timestamp++;
+}
+
+static void task_fifo(uint8_t events) {
+
+	struct mpu6050_sample fifo_sample;
+	uint8_t fifo_bytes[MPU6050_FIFO_SAMPLE_SIZE];
+
+	/* the sensor keeps sampling in between, up to 170 samples fit 
+	 * into its FIFO */
+	if(mpu6050_fifo_drain()) {
+		send_error(FAILURE_TW_BURST_READ);
+		return;
+	}
+	if(!mpu6050_sample_get(&fifo_sample)) {
+		return;
+	}
+	/* send all samples in one frame, the timestamp is the index 
+	 * of the first sample, in ms at 1 kHz */
+	frame_begin(FRAME_TYPE_ACC, timestamp);
+	do {
+		fifo_bytes[0] = (uint8_t)(fifo_sample.acc_x >> 8);
+		fifo_bytes[1] = (uint8_t)(fifo_sample.acc_x);
+		fifo_bytes[2] = (uint8_t)(fifo_sample.acc_y >> 8);
+		fifo_bytes[3] = (uint8_t)(fifo_sample.acc_y);
+		fifo_bytes[4] = (uint8_t)(fifo_sample.acc_z >> 8);
+		fifo_bytes[5] = (uint8_t)(fifo_sample.acc_z);
+		frame_put(&fifo_bytes[0], MPU6050_FIFO_SAMPLE_SIZE);
+		timestamp++;
+	} while(mpu6050_sample_get(&fifo_sample));
+	frame_end();
+}
+
+static void task_drdy(uint8_t events) {
+
+	uint8_t drdy_sample[MPU6050_SAMPLE_SIZE];
+
+	if(mpu6050_drdy_get(&drdy_sample[0])) {
+		frame_send(FRAME_TYPE_SAMPLE, timestamp++, &drdy_sample[0], MPU6050_SAMPLE_SIZE);
+	}
+}
+
+static void task_twi(uint8_t events) {
+	if(twi_service() == TWI_ERROR_BUS_STUCK) {
+		send_error(FAILURE_TW_BUS_STUCK);
+	}
+}
+
+static void task_report(uint8_t events) {
+
+	uint8_t id = 0;
+	uint16_t worst = 0;
+	uint8_t bytes[2];
+
+	/* every slot of the table, unused ones report 0 */
+	frame_begin(FRAME_TYPE_TASKS, timestamp);
+	for(id = 0; id < SCHED_MAX_TASKS; id++) {
+		worst = sched_worst_case(id);
+		bytes[0] = (uint8_t)worst;
+		bytes[1] = (uint8_t)(worst >> 8);
+		frame_put(&bytes[0], 2);
+	}
+	frame_end();
+}
+
+static void drdy_notify(void) {
+	sched_event_set(EVENT_SAMPLE);
+}
+
+static void tick_setup(void) {
+	/* CTC mode, see the timer demos for details */
+	TCCR2A = (1 << WGM21);
+	OCR2A = TICK_COMPARE_VALUE;
+	TIMSK2 = (1 << OCIE2A);
+	/* prescaler 64, for Timer2 this is CS22 only */
+	TCCR2B = (1 << CS22);
+}
+
 uint8_t MPU6050_wakeup() {
 
 	uint8_t error_code = OK;
@@ -186,7 +373,7 @@ uint8_t MPU6050_wakeup() {
 	twi_start();
 	if(twi_status() != TW_START) {
 		error_code = FAILURE_TW_START;
-		uart_send(error_code);
+		send_error(error_code);
 		goto stop;
 	}
 	/* send address */
@@ -194,7 +381,7 @@ uint8_t MPU6050_wakeup() {
 	/* wait for ACK */
 	if(twi_status() != TW_MT_SLA_ACK) {
 		error_code = FAILURE_TW_MT_SLA_ACK;
-		uart_send(error_code);
+		send_error(error_code);
 		goto stop;
 	}
 	
@@ -203,7 +390,7 @@ uint8_t MPU6050_wakeup() {
 	twi_write(MPU6050_POWER_REGISTER);
 	if(twi_status() != TW_MT_DATA_ACK) {
 		error_code = FAILURE_TW_MT_DATA_ACK;
-		uart_send(error_code);
+		send_error(error_code);
 		goto stop;
 	}
 	
@@ -211,7 +398,7 @@ uint8_t MPU6050_wakeup() {
 	twi_write(0x00);
 	if(twi_status() != TW_MT_DATA_ACK) {
 		error_code = FAILURE_TW_MT_DATA_ACK;
-		uart_send(error_code);
+		send_error(error_code);
 		goto stop;
 	}
 	
@@ -227,70 +414,27 @@ stop:
 	
 }
 
-uint8_t MPU6050_read(uint8_t *data, uint8_t addr) {
+uint8_t MPU6050_read_sample(uint8_t *sample) {
 
 	uint8_t error_code = OK;
 
-	*data = 0x00;
-
-	twi_start();
-	if(twi_status() != TW_START) {
-		error_code = FAILURE_TW_START;
-		uart_send(error_code);
-		goto stop;
-	}
-	/* send address */
-	twi_write((MPU6050_ADDR));
-	/* wait for ACK */
-	if(twi_status() != TW_MT_SLA_ACK) {
-		error_code = FAILURE_TW_MT_SLA_ACK;
-		uart_send(error_code);
-		goto stop;
-	}
-
-	/* register we want to read from */
-	twi_write(addr);
-	/* wait for ACK */
-	if(twi_status() != TW_MT_DATA_ACK) {
-		error_code = FAILURE_TW_MT_DATA_ACK;
-		uart_send(error_code);
-		goto stop;
-	}
-	
-	/* repeated start condition */
-	twi_start();
-	if(twi_status() != TW_REP_START) {
-		error_code = FAILURE_TW_REP_START;
-		uart_send(error_code);
-		goto stop;
-	}
-	
-	/* read operation */
-	twi_write((MPU6050_ADDR) | 1);
-	if(twi_status() != TW_MR_SLA_ACK) {
-		error_code = FAILURE_TW_MR_SLA_ACK;
-		uart_send(error_code);
-		goto stop;
-	}
-	
-	/* get data and tell sensor we want no more */
-	*data = twi_read_nack();
-	if(twi_status() != TW_MR_DATA_NACK) {
-		error_code = FAILURE_TW_MR_DATA_NACK;
-		uart_send(error_code);
-		goto stop;
-	}
-	
-stop:
-
-	twi_stop();
-	
-	if(error_code != OK) {
+	/* one transaction for all 14 registers instead of one for each */
+	if(twi_read_regs(MPU6050_I2C_ADDR, MPU6050_SAMPLE_REGISTER, sample, MPU6050_SAMPLE_SIZE)) {
+		error_code = FAILURE_TW_BURST_READ;
+		send_error(error_code);
 		return 1;
 	}
-	
+
 	return 0;
-	
+
 }
 
+/*********************************************************************
+ * INTERRUPT SERVICE ROUTINE
+ *********************************************************************/
+/* 1 ms tick */
+ISR (TIMER2_COMPA_vect) {
+	twi_tick();
+	sched_tick();
+}
 
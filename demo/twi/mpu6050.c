@@ -0,0 +1,274 @@
+/*********************************************************************
+ * MPU6050 Sensor Driver - C File
+ * Short Name: mpu6050
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: high rate sampling of the MPU6050 using its FIFO
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ * [17.10.2026][nmt]: data ready interrupt on INT0
+ * [17.10.2026][nmt]: notification of new data ready samples
+ * [17.10.2026][nmt]: atomic read of the dropped counter
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#include "mpu6050.h"
+#include "twi.h"
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+#define MPU6050_SAMPLE_MASK (MPU6050_SAMPLE_BUFFER_SIZE - 1)
+
+/*********************************************************************
+ * VARIABLES
+ *********************************************************************/
+/* ring buffer for the samples, mpu6050_fifo_drain writes the head,
+ * mpu6050_sample_get the tail */
+static volatile struct mpu6050_sample samples[MPU6050_SAMPLE_BUFFER_SIZE];
+static volatile uint8_t sample_head = 0;
+static volatile uint8_t sample_tail = 0;
+
+static volatile uint16_t dropped = 0;
+
+/* data ready mode, the TWI engine reads into drdy_raw, the callback
+ * copies a finished sample to drdy_sample */
+static void mpu6050_drdy_done(struct twi_transaction *transaction);
+
+static const uint8_t drdy_reg = MPU6050_SAMPLE_REGISTER;
+static uint8_t drdy_raw[MPU6050_SAMPLE_SIZE];
+static volatile uint8_t drdy_sample[MPU6050_SAMPLE_SIZE];
+static volatile uint8_t drdy_new = 0;
+static void (*drdy_notify)(void) = 0;
+
+static struct twi_transaction drdy_transaction = {
+	.addr = MPU6050_I2C_ADDR,
+	.tx_data = &drdy_reg,
+	.tx_len = 1,
+	.rx_data = &drdy_raw[0],
+	.rx_len = MPU6050_SAMPLE_SIZE,
+	.callback = mpu6050_drdy_done,
+	.state = TWI_TRANSACTION_OK
+};
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+/* writes a single register of the sensor */
+static uint8_t mpu6050_write_reg(uint8_t reg, uint8_t data) {
+	return twi_write_regs(MPU6050_I2C_ADDR, reg, &data, 1);
+}
+
+/* throws away the content of the FIFO and starts filling it again */
+static uint8_t mpu6050_fifo_reset(void) {
+	if(mpu6050_write_reg(MPU6050_USER_CTRL_REGISTER, MPU6050_USER_CTRL_FIFO_RESET)) {
+		return 1;
+	}
+	return mpu6050_write_reg(MPU6050_USER_CTRL_REGISTER, MPU6050_USER_CTRL_FIFO_EN);
+}
+
+uint8_t mpu6050_fifo_init(uint8_t divider) {
+
+	/* the DLPF sets the internal rate to 1 kHz, the divider reduces
+	 * it further */
+	if(mpu6050_write_reg(MPU6050_CONFIG_REGISTER, MPU6050_CONFIG_DLPF_184HZ)) {
+		return 1;
+	}
+	if(mpu6050_write_reg(MPU6050_SMPLRT_DIV_REGISTER, divider)) {
+		return 1;
+	}
+	/* only the accelerometer values go into the FIFO */
+	if(mpu6050_write_reg(MPU6050_FIFO_EN_REGISTER, MPU6050_FIFO_EN_ACCEL)) {
+		return 1;
+	}
+	/* flag a new sample and an overflowing FIFO in INT_STATUS */
+	if(mpu6050_write_reg(MPU6050_INT_ENABLE_REGISTER, 
+				MPU6050_INT_DATA_RDY | MPU6050_INT_FIFO_OFLOW)) {
+		return 1;
+	}
+
+	return mpu6050_fifo_reset();
+}
+
+uint8_t mpu6050_fifo_drain(void) {
+
+	uint8_t buf[MPU6050_FIFO_CHUNK * MPU6050_FIFO_SAMPLE_SIZE];
+	uint8_t *data = 0;
+	uint8_t status = 0;
+	uint16_t count = 0;
+	uint8_t chunk = 0;
+	uint8_t next = 0;
+
+	/* reading INT_STATUS also clears it */
+	if(twi_read_regs(MPU6050_I2C_ADDR, MPU6050_INT_STATUS_REGISTER, &status, 1)) {
+		return 1;
+	}
+	if(status & MPU6050_INT_FIFO_OFLOW) {
+		/* the FIFO is no longer aligned to samples, start over */
+		dropped++;
+		return mpu6050_fifo_reset();
+	}
+
+	/* number of bytes in the FIFO, high byte first */
+	if(twi_read_regs(MPU6050_I2C_ADDR, MPU6050_FIFO_COUNT_REGISTER, &buf[0], 2)) {
+		return 1;
+	}
+	count = ((uint16_t)buf[0] << 8) | buf[1];
+	/* only take complete samples, the rest is read next time */
+	count /= MPU6050_FIFO_SAMPLE_SIZE;
+
+	while(count) {
+		
+		chunk = (count > MPU6050_FIFO_CHUNK) ? MPU6050_FIFO_CHUNK : count;
+		count -= chunk;
+
+		/* FIFO_R_W does not auto increment, so a burst read returns
+		 * consecutive FIFO bytes */
+		if(twi_read_regs(MPU6050_I2C_ADDR, MPU6050_FIFO_R_W_REGISTER, &buf[0], 
+					chunk * MPU6050_FIFO_SAMPLE_SIZE)) {
+			return 1;
+		}
+
+		for(data = &buf[0]; chunk; chunk--, data += MPU6050_FIFO_SAMPLE_SIZE) {
+			next = (sample_head + 1) & MPU6050_SAMPLE_MASK;
+			if(next == sample_tail) {
+				/* ring buffer is full */
+				dropped++;
+				continue;
+			}
+			samples[sample_head].acc_x = (int16_t)(((uint16_t)data[0] << 8) | data[1]);
+			samples[sample_head].acc_y = (int16_t)(((uint16_t)data[2] << 8) | data[3]);
+			samples[sample_head].acc_z = (int16_t)(((uint16_t)data[4] << 8) | data[5]);
+			sample_head = next;
+		}
+	}
+
+	return 0;
+}
+
+uint8_t mpu6050_sample_get(struct mpu6050_sample *sample) {
+
+	uint8_t tail = sample_tail;
+
+	if(tail == sample_head) {
+		return 0;
+	}
+
+	*sample = samples[tail];
+	sample_tail = (tail + 1) & MPU6050_SAMPLE_MASK;
+
+	return 1;
+}
+
+uint16_t mpu6050_dropped(void) {
+
+	uint8_t sreg = SREG;
+	uint16_t count = 0;
+
+	/* 16 bit, INT0 and the TWI callbacks could change it between the
+	 * two byte reads */
+	cli();
+	count = dropped;
+	SREG = sreg;
+
+	return count;
+}
+
+uint8_t mpu6050_drdy_init(uint8_t divider, void (*notify)(void)) {
+
+	drdy_notify = notify;
+
+	if(mpu6050_write_reg(MPU6050_CONFIG_REGISTER, MPU6050_CONFIG_DLPF_184HZ)) {
+		return 1;
+	}
+	if(mpu6050_write_reg(MPU6050_SMPLRT_DIV_REGISTER, divider)) {
+		return 1;
+	}
+	/* a short high pulse for every new sample, no need to clear it */
+	if(mpu6050_write_reg(MPU6050_INT_PIN_CFG_REGISTER, MPU6050_INT_PIN_CFG_PULSE)) {
+		return 1;
+	}
+	if(mpu6050_write_reg(MPU6050_INT_ENABLE_REGISTER, MPU6050_INT_DATA_RDY)) {
+		return 1;
+	}
+
+	/* pin D2 as an input without pullup, the sensor drives it */
+	DDRD &= ~(1 << DDD2);
+	PORTD &= ~(1 << PORTD2);
+	/* trigger INT0 on the rising edge, table 12-2 of the ATmega328p
+	 * datasheet */
+	EICRA = (EICRA & ~((1 << ISC01) | (1 << ISC00))) | (1 << ISC01) | (1 << ISC00);
+	/* clear an old request and enable interrupt request 0 */
+	EIFR = (1 << INTF0);
+	EIMSK |= (1 << INT0);
+
+	return 0;
+}
+
+uint8_t mpu6050_drdy_get(uint8_t *sample) {
+
+	uint8_t i = 0;
+	uint8_t sreg = SREG;
+
+	if(!drdy_new) {
+		return 0;
+	}
+
+	/* the callback must not update the sample while we copy it */
+	cli();
+	for(i = 0; i < MPU6050_SAMPLE_SIZE; i++) {
+		sample[i] = drdy_sample[i];
+	}
+	drdy_new = 0;
+	SREG = sreg;
+
+	return 1;
+}
+
+/* called by the TWI engine once the burst read is finished */
+static void mpu6050_drdy_done(struct twi_transaction *transaction) {
+
+	uint8_t i = 0;
+
+	if(transaction->state != TWI_TRANSACTION_OK) {
+		dropped++;
+		return;
+	}
+	for(i = 0; i < MPU6050_SAMPLE_SIZE; i++) {
+		drdy_sample[i] = drdy_raw[i];
+	}
+	drdy_new = 1;
+	if(drdy_notify) {
+		drdy_notify();
+	}
+}
+
+/*********************************************************************
+ * INTERRUPT SERVICE ROUTINE
+ *********************************************************************/
+/* the sensor has a new sample, start reading it in the background */
+ISR (INT0_vect) {
+
+	/* the previous read is still running, skip this sample */
+	if((drdy_transaction.state == TWI_TRANSACTION_QUEUED) || 
+		 (drdy_transaction.state == TWI_TRANSACTION_BUSY)) {
+		dropped++;
+		return;
+	}
+	if(twi_submit(&drdy_transaction)) {
+		dropped++;
+	}
+}
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
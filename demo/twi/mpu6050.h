@@ -0,0 +1,154 @@
+/*********************************************************************
+ * MPU6050 Sensor Driver - Header File
+ * Short Name: mpu6050
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: high rate sampling of the MPU6050 using its FIFO
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ * [17.10.2026][nmt]: data ready interrupt on INT0
+ * [17.10.2026][nmt]: notification of new data ready samples
+ *********************************************************************/
+
+/*********************************************************************
+ * NOTES:	register addresses are given according to the MPU6050 
+ *				register map (RM-MPU-6000A). The sensor must be woken up
+ *				before using these functions.
+ *				For the data ready mode connect the INT pin of the sensor 
+ *				to pin D2 (INT0) of the arduino.
+ *********************************************************************/
+
+#ifndef MPU6050_H
+#define MPU6050_H
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <stdint.h>
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* 7-bit I2C address, AD0 is not set */
+#define MPU6050_I2C_ADDR 0x68
+
+/* register addresses */
+#define MPU6050_SMPLRT_DIV_REGISTER 0x19
+#define MPU6050_CONFIG_REGISTER 0x1a
+#define MPU6050_FIFO_EN_REGISTER 0x23
+#define MPU6050_INT_PIN_CFG_REGISTER 0x37
+#define MPU6050_INT_ENABLE_REGISTER 0x38
+#define MPU6050_INT_STATUS_REGISTER 0x3a
+#define MPU6050_USER_CTRL_REGISTER 0x6a
+#define MPU6050_FIFO_COUNT_REGISTER 0x72 /* high byte, low byte follows */
+#define MPU6050_FIFO_R_W_REGISTER 0x74
+
+/* register bits */
+#define MPU6050_CONFIG_DLPF_184HZ 0x01 /* internal sample rate is 1 kHz */
+#define MPU6050_FIFO_EN_ACCEL 0x08
+#define MPU6050_INT_PIN_CFG_PULSE 0x00 /* active high, push-pull, 50 us pulse */
+#define MPU6050_INT_FIFO_OFLOW 0x10
+#define MPU6050_INT_DATA_RDY 0x01
+#define MPU6050_USER_CTRL_FIFO_EN 0x40
+#define MPU6050_USER_CTRL_FIFO_RESET 0x04
+
+/* the sensor values are stored in consecutive registers, accelerometer
+ * x/y/z, temperature and gyroscope x/y/z, each high byte first */
+#define MPU6050_SAMPLE_REGISTER 0x3b
+#define MPU6050_SAMPLE_SIZE 14
+
+/* the sample rate is 1 kHz / (1 + divider) with the DLPF enabled, 
+ * so a divider of 0 samples at 1 kHz */
+#define MPU6050_DIVIDER_1KHZ 0
+#define MPU6050_DIVIDER_100HZ 9
+
+/* only the accelerometer is written to the FIFO, 3 axes with 2 bytes */
+#define MPU6050_FIFO_SAMPLE_SIZE 6
+/* samples read from the FIFO in one transaction, the bytes are 
+ * buffered on the stack */
+#define MPU6050_FIFO_CHUNK 8
+
+/* number of samples in the RAM ring buffer, must be a power of two,
+ * at 1 kHz this must hold the samples of one drain period */
+#define MPU6050_SAMPLE_BUFFER_SIZE 32
+
+#if (MPU6050_SAMPLE_BUFFER_SIZE & (MPU6050_SAMPLE_BUFFER_SIZE - 1)) || (MPU6050_SAMPLE_BUFFER_SIZE > 128)
+	#error "MPU6050: MPU6050_SAMPLE_BUFFER_SIZE must be a power of two <= 128"
+#endif
+
+/*********************************************************************
+ * TYPES
+ *********************************************************************/
+/* one accelerometer sample as stored in the ring buffer */
+struct mpu6050_sample {
+	int16_t acc_x;
+	int16_t acc_y;
+	int16_t acc_z;
+};
+
+/*********************************************************************
+ * FUNCTION PROTOTYPES
+ *********************************************************************/
+
+/**
+ * @brief sets the sample rate and starts writing accelerometer 
+ * samples into the FIFO of the sensor
+ * @param divider sample rate divider, see MPU6050_DIVIDER_*
+ * @return 0 on success, 1 on a TWI failure
+ */
+uint8_t mpu6050_fifo_init(uint8_t divider);
+
+/**
+ * @brief moves all complete samples from the sensor FIFO into the 
+ * RAM ring buffer using burst reads
+ * NOTE: call this often enough that the 1024 byte FIFO of the sensor
+ * does not overflow, that is every 170 ms at 1 kHz. On an overflow 
+ * the FIFO is reset and the drop counter is incremented.
+ * @return 0 on success, 1 on a TWI failure
+ */
+uint8_t mpu6050_fifo_drain(void);
+
+/**
+ * @brief takes the oldest sample from the ring buffer
+ * @param sample storage for the sample
+ * @return 1 if a sample was stored, 0 if the buffer is empty
+ */
+uint8_t mpu6050_sample_get(struct mpu6050_sample *sample);
+
+/**
+ * @brief number of samples lost, either because the ring buffer was
+ * full or because the sensor FIFO overflowed (counted as one)
+ * @return the drop counter
+ */
+uint16_t mpu6050_dropped(void);
+
+/* NOTE: the data ready mode uses INT0 and the interrupt driven TWI 
+ * engine, global interrupts must be enabled. Do not use the blocking
+ * TWI functions while it is running. */
+
+/**
+ * @brief sets the sample rate and starts a burst read of a complete 
+ * sample whenever the sensor signals new data on INT0
+ * @param divider sample rate divider, see MPU6050_DIVIDER_*
+ * @param notify called from the TWI interrupt when a new sample is 
+ * ready, e.g. to set a scheduler event, may be NULL
+ * @return 0 on success, 1 on a TWI failure
+ */
+uint8_t mpu6050_drdy_init(uint8_t divider, void (*notify)(void));
+
+/**
+ * @brief takes the latest sample read in the data ready mode
+ * @param sample storage for MPU6050_SAMPLE_SIZE bytes, raw register 
+ * values starting at MPU6050_SAMPLE_REGISTER
+ * @return 1 if a new sample was stored, 0 otherwise
+ */
+uint8_t mpu6050_drdy_get(uint8_t *sample);
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
+#endif
@@ -0,0 +1,268 @@
+/*********************************************************************
+ * Cooperative Scheduler - C File
+ * Short Name: sched
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: runs periodic, one-shot and event driven tasks from a 
+ *							fixed table, sleeps when there is nothing to do
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ * [17.10.2026][nmt]: explained the missed millisecond in sched_now
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+#include "sched.h"
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* flags of a task */
+#define SCHED_TIMED 0x01		/* runs at next */
+#define SCHED_ONESHOT 0x02	/* removed after it ran at next */
+
+/*********************************************************************
+ * TYPES
+ *********************************************************************/
+/* an entry of the task table, free if task is 0 */
+struct sched_entry {
+	sched_task_t task;
+	uint16_t period;		/* ms, periodic tasks only */
+	uint16_t next;			/* time of the next run */
+	uint8_t events;			/* events the task waits for */
+	uint8_t flags;
+	uint16_t worst;			/* longest run time in us */
+};
+
+/* a point in time for the run time measurement */
+struct sched_time {
+	uint16_t ms;
+	uint8_t count;
+};
+
+/*********************************************************************
+ * VARIABLES
+ *********************************************************************/
+static struct sched_entry tasks[SCHED_MAX_TASKS];
+
+/* written by the interrupts */
+static volatile uint16_t sched_ms = 0;
+static volatile uint8_t sched_events = 0;
+/* set by sched_tick, tells sched_run that tasks may be due */
+static volatile uint8_t sched_ticked = 0;
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+static uint8_t sched_add(sched_task_t task, uint16_t period, uint16_t delay,
+		uint8_t events, uint8_t flags) {
+
+	uint8_t id = 0;
+
+	for(id = 0; id < SCHED_MAX_TASKS; id++) {
+		if(!tasks[id].task) {
+			tasks[id].period = period;
+			tasks[id].next = sched_millis() + delay;
+			tasks[id].events = events;
+			tasks[id].flags = flags;
+			tasks[id].worst = 0;
+			/* last, the slot is used from here on */
+			tasks[id].task = task;
+			return id;
+		}
+	}
+	return SCHED_INVALID;
+}
+
+uint8_t sched_add_periodic(sched_task_t task, uint16_t period_ms, uint16_t offset_ms) {
+	if(!period_ms) {
+		return SCHED_INVALID;
+	}
+	return sched_add(task, period_ms, offset_ms, 0, SCHED_TIMED);
+}
+
+uint8_t sched_add_oneshot(sched_task_t task, uint16_t delay_ms) {
+	return sched_add(task, 0, delay_ms, 0, SCHED_TIMED | SCHED_ONESHOT);
+}
+
+uint8_t sched_add_event(sched_task_t task, uint8_t events) {
+	return sched_add(task, 0, 0, events, 0);
+}
+
+void sched_remove(uint8_t id) {
+	if(id < SCHED_MAX_TASKS) {
+		tasks[id].task = 0;
+	}
+}
+
+void sched_event_set(uint8_t events) {
+
+	uint8_t sreg = SREG;
+
+	cli();
+	sched_events |= events;
+	SREG = sreg;
+}
+
+void sched_tick(void) {
+	sched_ms++;
+	sched_ticked = 1;
+}
+
+uint16_t sched_millis(void) {
+
+	uint8_t sreg = SREG;
+	uint16_t ms = 0;
+
+	cli();
+	ms = sched_ms;
+	SREG = sreg;
+
+	return ms;
+}
+
+/* takes the time with the resolution of the timer count */
+static void sched_now(struct sched_time *now) {
+
+	uint8_t sreg = SREG;
+
+	cli();
+	now->ms = sched_ms;
+	now->count = SCHED_TIMER_COUNT;
+	/* the counter may have passed the compare match after cli, then 
+	 * it started over but the ISR could not count the millisecond 
+	 * yet. The pending flag with a count below the top can only be 
+	 * after such a match, so the millisecond is added here. */
+	if(SCHED_TIMER_PENDING && (now->count < SCHED_TIMER_TOP)) {
+		now->ms++;
+	}
+	SREG = sreg;
+}
+
+/* microseconds between two points in time, stops at 65535 */
+static uint16_t sched_elapsed(const struct sched_time *start, const struct sched_time *end) {
+
+	uint16_t ms = end->ms - start->ms;
+	int32_t us = (int32_t)ms * 1000L + 
+		((int16_t)end->count - (int16_t)start->count) * (int16_t)SCHED_US_PER_COUNT;
+
+	if(us > 0xffff) {
+		return 0xffff;
+	}
+	if(us < 0) {
+		return 0;
+	}
+	return (uint16_t)us;
+}
+
+uint8_t sched_dispatch(void) {
+
+	uint8_t id = 0;
+	uint8_t ran = 0;
+	uint8_t sreg = SREG;
+	uint8_t events = 0;
+	uint8_t task_events = 0;
+	uint8_t due = 0;
+	uint16_t now = 0;
+	uint16_t elapsed = 0;
+	sched_task_t task = 0;
+	struct sched_time start;
+	struct sched_time end;
+
+	/* take all events at once, events set from here on are handled 
+	 * in the next pass */
+	cli();
+	now = sched_ms;
+	events = sched_events;
+	sched_events = 0;
+	sched_ticked = 0;
+	SREG = sreg;
+
+	for(id = 0; id < SCHED_MAX_TASKS; id++) {
+
+		task = tasks[id].task;
+		if(!task) {
+			continue;
+		}
+
+		task_events = tasks[id].events & events;
+		/* the difference also works when the time wraps */
+		due = (tasks[id].flags & SCHED_TIMED) && ((int16_t)(now - tasks[id].next) >= 0);
+
+		if(!due && !task_events) {
+			continue;
+		}
+
+		if(due) {
+			if(tasks[id].flags & SCHED_ONESHOT) {
+				/* remove it first, so it can add itself again */
+				tasks[id].task = 0;
+			} else {
+				/* stay on the grid of the period, but skip runs that 
+				 * were missed completely instead of catching up */
+				tasks[id].next += tasks[id].period;
+				if((int16_t)(now - tasks[id].next) >= 0) {
+					tasks[id].next = now + tasks[id].period;
+				}
+			}
+		}
+
+		sched_now(&start);
+		task(task_events);
+		sched_now(&end);
+
+		elapsed = sched_elapsed(&start, &end);
+		if(elapsed > tasks[id].worst) {
+			tasks[id].worst = elapsed;
+		}
+		ran++;
+	}
+
+	return ran;
+}
+
+void sched_run(void) {
+
+	/* idle mode keeps the timers, TWI, UART and external interrupts 
+	 * running */
+	set_sleep_mode(SLEEP_MODE_IDLE);
+
+	while(1) {
+
+		if(sched_dispatch()) {
+			continue;
+		}
+
+		/* check with interrupts disabled, otherwise an interrupt 
+		 * between the check and sleep_cpu would not wake us. sei 
+		 * takes effect after the next instruction, so we are asleep 
+		 * before any interrupt runs. */
+		cli();
+		if(!sched_events && !sched_ticked) {
+			sleep_enable();
+			sei();
+			sleep_cpu();
+			sleep_disable();
+		}
+		sei();
+	}
+}
+
+uint16_t sched_worst_case(uint8_t id) {
+	if(id >= SCHED_MAX_TASKS) {
+		return 0;
+	}
+	return tasks[id].worst;
+}
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
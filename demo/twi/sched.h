@@ -0,0 +1,139 @@
+/*********************************************************************
+ * Cooperative Scheduler - Header File
+ * Short Name: sched
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: runs periodic, one-shot and event driven tasks from a 
+ *							fixed table, sleeps when there is nothing to do
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * NOTES:	tasks are functions that do a small piece of work and 
+ *				return, they are never interrupted by another task. A 
+ *				task that takes long delays all others, check the worst
+ *				case run times with sched_worst_case.
+ *
+ *				Tasks run in the order of the table, so tasks added first
+ *				have priority when several are due at the same time. 
+ *				Interrupts signal the main loop with events, e.g. the 
+ *				UART receive interrupt calls sched_event_set(EVENT_RX) and
+ *				a task added with sched_add_event(task, EVENT_RX) runs.
+ *
+ *				Times are in milliseconds with 16 bits, periods and delays
+ *				must be below 32768 ms.
+ *********************************************************************/
+
+#ifndef SCHED_H
+#define SCHED_H
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <stdint.h>
+
+#include "sched_cfg.h"
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* returned by the sched_add functions if the table is full */
+#define SCHED_INVALID 0xff
+
+/* event flags, up to 8 events */
+#define SCHED_EVENT(n) (1 << (n))
+
+/*********************************************************************
+ * TYPES
+ *********************************************************************/
+/* a task, events are the events it was started for, 0 if it was 
+ * started because it was due */
+typedef void (*sched_task_t)(uint8_t events);
+
+/*********************************************************************
+ * FUNCTION PROTOTYPES
+ *********************************************************************/
+
+/**
+ * @brief adds a task that runs every period
+ * @param task the task
+ * @param period_ms time between two runs [1 - 32767]
+ * @param offset_ms time until the first run, spreads tasks with the 
+ * same period
+ * @return task id, SCHED_INVALID if the table is full
+ */
+uint8_t sched_add_periodic(sched_task_t task, uint16_t period_ms, uint16_t offset_ms);
+
+/**
+ * @brief adds a task that runs once after a delay, then it is removed
+ * @param task the task
+ * @param delay_ms time until it runs [0 - 32767]
+ * @return task id, SCHED_INVALID if the table is full
+ */
+uint8_t sched_add_oneshot(sched_task_t task, uint16_t delay_ms);
+
+/**
+ * @brief adds a task that runs when one of its events is set
+ * @param task the task
+ * @param events the events, see SCHED_EVENT
+ * @return task id, SCHED_INVALID if the table is full
+ */
+uint8_t sched_add_event(sched_task_t task, uint8_t events);
+
+/**
+ * @brief removes a task, a task may remove itself
+ * @param id task id
+ * @return void
+ */
+void sched_remove(uint8_t id);
+
+/**
+ * @brief sets events, the tasks waiting for them run on the next pass
+ * NOTE: may be called from interrupts
+ * @param events the events, see SCHED_EVENT
+ * @return void
+ */
+void sched_event_set(uint8_t events);
+
+/**
+ * @brief advances the time of the scheduler by 1 ms
+ * NOTE: call it from the 1 ms timer interrupt, see sched_cfg.h
+ * @return void
+ */
+void sched_tick(void);
+
+/**
+ * @brief milliseconds since start
+ * @return milliseconds, wraps after 65.5 s
+ */
+uint16_t sched_millis(void);
+
+/**
+ * @brief runs every task that is due or has an event once
+ * @return number of tasks that ran
+ */
+uint8_t sched_dispatch(void);
+
+/**
+ * @brief runs the tasks forever, sleeps in idle mode in between
+ * NOTE: needs global interrupts, the 1 ms tick wakes the CPU
+ * @return never
+ */
+void sched_run(void);
+
+/**
+ * @brief longest run time of a task so far
+ * @param id task id
+ * @return run time in microseconds, stops at 65535
+ */
+uint16_t sched_worst_case(uint8_t id);
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
+#endif
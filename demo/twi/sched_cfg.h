@@ -0,0 +1,50 @@
+/*********************************************************************
+ * Cooperative Scheduler - Configuration File
+ * Short Name: sched_cfg
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: Settings for the scheduler, size of the task table and
+ *							time base of the run time measurement
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+#ifndef SCHED_CFG_H
+#define SCHED_CFG_H
+
+#include <avr/io.h>
+
+/* set CPU frequency for the run time measurement */
+#ifndef F_CPU
+	#warning "SCHED_CFG: F_CPU was undefined setting to 16 MHz"
+	#define F_CPU 16000000UL
+#endif
+
+/* number of entries of the task table, a task uses 10 bytes of SRAM */
+#define SCHED_MAX_TASKS 6
+
+/* NOTE: sched_tick has to be called every millisecond by a timer in 
+ * CTC mode. Its counter measures the run time of the tasks, together
+ * with the milliseconds. These macros tell the scheduler which timer 
+ * it is, here Timer2 at prescaler 64 like in main.c. */
+#define SCHED_TIMER_COUNT TCNT2
+#define SCHED_TIMER_TOP OCR2A
+/* set if the compare match happened but sched_tick did not run yet */
+#define SCHED_TIMER_PENDING (TIFR2 & (1 << OCF2A))
+#define SCHED_TIMER_PRESCALER 64UL
+
+/* microseconds per count of the timer */
+#define SCHED_US_PER_COUNT (SCHED_TIMER_PRESCALER * 1000000UL / F_CPU)
+
+#if (SCHED_US_PER_COUNT < 1) || ((SCHED_TIMER_PRESCALER * 1000000UL) % F_CPU)
+	#error "SCHED_CFG: a count of the timer is not a whole number of microseconds"
+#endif
+#if (SCHED_MAX_TASKS < 1) || (SCHED_MAX_TASKS > 254)
+	#error "SCHED_CFG: SCHED_MAX_TASKS must be in [1 - 254]"
+#endif
+
+#endif
@@ -10,21 +10,149 @@
  * Changelog:
  * [Date][Author]:[Change]
  * [14.09.2019][nmt]: initial commit
+ * [17.10.2026][nmt]: interrupt driven transaction engine
+ * [17.10.2026][nmt]: burst register read
+ * [17.10.2026][nmt]: burst register write
+ * [17.10.2026][nmt]: SCL setup from twi_cfg.h, twi_set_clock
+ * [17.10.2026][nmt]: timeouts, bus clear and error results
+ * [17.10.2026][nmt]: the engine leaves the bus clear to twi_service
+ * [17.10.2026][nmt]: a full queue leaves the transaction untouched,
+ *										callbacks may submit the next transaction
  *********************************************************************/
  
  /*********************************************************************
  * NOTES: 	references to the registers used are given according to the
  *					ATMega328p datasheet
  * FUTURE WORK:
- * 			add a header configuration file for SCL setup based on the
- * 			CPU frequency, add a macro for the mask used in twi_status
+ * 			add a macro for the mask used in twi_status
  *********************************************************************/
 
 /*********************************************************************
  * LIBRARIES
  *********************************************************************/ 
+#include <avr/interrupt.h>
+#include <util/delay.h>
+
 #include "twi.h"
 
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+#define TWI_QUEUE_MASK (TWI_QUEUE_SIZE - 1)
+
+/* control register values used by the interrupt driven engine, all 
+ * of them clear TWINT and keep the module and its interrupt enabled */
+#define TWI_ISR_START		((1<<TWINT) | (1<<TWSTA) | (1<<TWEN) | (1<<TWIE))
+#define TWI_ISR_STOP		((1<<TWINT) | (1<<TWSTO) | (1<<TWEN))
+#define TWI_ISR_NEXT		((1<<TWINT) | (1<<TWEN) | (1<<TWIE))
+#define TWI_ISR_ACK			((1<<TWINT) | (1<<TWEN) | (1<<TWIE) | (1<<TWEA))
+
+/* SDA and SCL of the TWI are pins C4 and C5 */
+#define TWI_SDA PC4
+#define TWI_SCL PC5
+/* half of an SCL period of the bus clear, 5 us gives 100 kHz */
+#define TWI_BUS_CLEAR_DELAY_US 5
+
+/*********************************************************************
+ * VARIABLES
+ *********************************************************************/
+/* transaction queue, twi_submit writes the head, the ISR the tail */
+static struct twi_transaction * volatile queue[TWI_QUEUE_SIZE];
+static volatile uint8_t queue_head = 0;
+static volatile uint8_t queue_tail = 0;
+
+/* the transaction on the bus, set whenever a start condition is 
+ * requested */
+static struct twi_transaction * volatile current = 0;
+/* progress of the current transaction, only used by the ISR */
+static uint8_t data_index = 0;
+
+/* remaining ticks of the current blocking wait and of the current
+ * step of the engine, decremented by twi_tick */
+static volatile uint8_t wait_ticks = 0;
+static volatile uint8_t engine_ticks = 0;
+/* set if the last blocking wait timed out */
+static uint8_t timed_out = 0;
+/* set by twi_tick after the engine timed out, the engine stays off
+ * until twi_service cleared the bus */
+static volatile uint8_t clear_pending = 0;
+/* set while the callback of a finished transaction runs, twi_submit
+ * only queues then and twi_engine_finish starts the next one */
+static volatile uint8_t engine_finishing = 0;
+/* status of the step that failed in twi_read_regs / twi_write_regs */
+static uint8_t error_status = TW_NO_INFO;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ *********************************************************************/
+/* waits until the TWI finished the current operation, gives up after
+ * TWI_TIMEOUT_TICKS calls of twi_tick */
+static void twi_wait(void) {
+
+	wait_ticks = TWI_TIMEOUT_TICKS;
+	timed_out = 0;
+
+	while((TWCR & (1<<TWINT)) == 0) {
+		if(wait_ticks == 0) {
+			timed_out = 1;
+			return;
+		}
+	}
+}
+
+/* compares the status to the one expected after a step, on a 
+ * mismatch the status is saved for twi_error_status */
+static uint8_t twi_check(uint8_t expected) {
+
+	uint8_t status = twi_status();
+
+	if(status == expected) {
+		return TWI_OK;
+	}
+	error_status = status;
+	return twi_result(status);
+}
+
+/* ends a transaction of twi_read_regs / twi_write_regs */
+static void twi_finish(uint8_t result) {
+	if((result == TWI_ERROR_TIMEOUT) || (result == TWI_ERROR_BUS)) {
+		/* the bus is in an unknown state, reset everything */
+		twi_bus_clear();
+	} else {
+		twi_stop();
+	}
+}
+
+/* finishes the transaction at the tail of the queue and starts the
+ * next one */
+static void twi_engine_finish(struct twi_transaction *trans) {
+
+	trans->state = (trans->twi_status == TW_NO_INFO) ? 
+										TWI_TRANSACTION_OK : TWI_TRANSACTION_ERROR;
+	queue_tail = (queue_tail + 1) & TWI_QUEUE_MASK;
+
+	/* a callback may submit the next transaction, TWCR is written once
+	 * below for whatever is queued then */
+	if(trans->callback) {
+		engine_finishing = 1;
+		trans->callback(trans);
+		engine_finishing = 0;
+	}
+
+	if(clear_pending) {
+		/* the TWI is off, twi_service starts the next one */
+		engine_ticks = 0;
+	} else if(queue_tail != queue_head) {
+		current = queue[queue_tail];
+		engine_ticks = TWI_TIMEOUT_TICKS;
+		/* STOP followed by START for the next transaction in the queue */
+		TWCR = TWI_ISR_START | (1<<TWSTO);
+	} else {
+		engine_ticks = 0;
+		TWCR = TWI_ISR_STOP;
+	}
+}
+
 /*********************************************************************
  * FUNCTIONS
  *********************************************************************/
@@ -32,25 +160,52 @@ void twi_init(void) {
 	
     /* clocking setup for SCL, calculated as follows: 
      * SCL_frequency = CPU frequency / (16+2*TWBR * Prescaler Value) 
-     * For a 16 MHz clock this equates to 16 MHz / 16+2*12 = 400 kHz
-     * using the setup below */
+     * twi_cfg.h solves this for TWI_SCL_FREQ at compile time, e.g.
+     * for a 16 MHz clock and 400 kHz TWBR is 12 with prescaler 1 */
      
     /* determines the prescaler value for the frequency of the bus */
-    TWSR = 0x00;
+    TWSR = TWI_TWPS_VALUE;
     /* defines the SCL period */
-    TWBR = 0x0C;
+    TWBR = TWI_TWBR_VALUE;
     
     /* enables the twi module in the TWI control register */
     TWCR = (1<<TWEN);
 }
 
+uint8_t twi_set_clock(uint32_t scl_freq) {
+
+	uint32_t ticks = 0;
+	uint32_t twbr = 0;
+	uint8_t twps = 0;
+
+	if(scl_freq == 0 || scl_freq > TWI_SCL_400KHZ) {
+		return 1;
+	}
+	/* same calculation as the macros in twi_cfg.h */
+	ticks = (F_CPU + scl_freq - 1) / scl_freq;
+	if(ticks < 16) {
+		return 1;
+	}
+	/* the smallest prescaler (4^twps) that lets TWBR fit in 8 bits */
+	for(twps = 0; twps < 4; twps++) {
+		twbr = (ticks - 16 + (2UL << (2 * twps)) - 1) / (2UL << (2 * twps));
+		if(twbr <= 255) {
+			TWSR = twps;
+			TWBR = (uint8_t)twbr;
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
 void twi_start(void) {
 	
 	/* clear interrupt, set start condition bit for operation as master
 	 *  and enable */
     TWCR = (1<<TWINT) | (1<<TWSTA) | (1<<TWEN);
     /* wait until the start condition is sent */
-    while ((TWCR & (1<<TWINT)) == 0);
+    twi_wait();
 }
 
 void twi_stop(void) {
@@ -65,14 +220,14 @@ void twi_write(uint8_t ui8_data) {
     /* clear the interrupt and enable */
     TWCR = (1<<TWINT) | (1<<TWEN);
     /* wait until the data is sent */
-    while ((TWCR & (1<<TWINT)) == 0);
+    twi_wait();
 }
 
 uint8_t twi_read_ack(void) {
 		/* clear the interrupt, enable and return an ACK upon reception */
     TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWEA);
     /* wait until receiving is done */
-    while ((TWCR & (1<<TWINT)) == 0);
+    twi_wait();
     /* return the received data stored in the twi data register */
     return TWDR;
 }
@@ -82,7 +237,7 @@ uint8_t twi_read_nack(void) {
 	 * this sends a NACK upon reception because TWEA is not set */
     TWCR = (1<<TWINT) | (1<<TWEN);
     /* wait until the data is received */
-    while ((TWCR & (1<<TWINT)) == 0);
+    twi_wait();
     /* return the received data */
     return TWDR;
 }
@@ -100,10 +255,313 @@ uint8_t twi_status(void) {
 	 * so mask with 11111000 = 0xF8 */
 	
     uint8_t status = 0x00;
+
+    /* the hardware does not know about our timeout */
+    if(timed_out) {
+        return TWI_STATUS_TIMEOUT;
+    }
     status = TWSR & 0xF8;
     return status;
 }
 
+uint8_t twi_result(uint8_t status) {
+
+	switch(status) {
+		case TWI_STATUS_TIMEOUT:	return TWI_ERROR_TIMEOUT;
+		case TW_MT_SLA_NACK:
+		case TW_MT_DATA_NACK:
+		case TW_MR_SLA_NACK:			return TWI_ERROR_NACK;
+		case TW_MT_ARB_LOST:			return TWI_ERROR_ARBITRATION;
+		case TW_BUS_ERROR:				return TWI_ERROR_BUS;
+		default:									return TWI_ERROR_STATE;
+	}
+}
+
+uint8_t twi_error_status(void) {
+	return error_status;
+}
+
+void twi_tick(void) {
+
+	if(wait_ticks) {
+		wait_ticks--;
+	}
+
+	/* the engine did not get an interrupt for too long, give up on 
+	 * the transaction on the bus */
+	if(engine_ticks && (--engine_ticks == 0)) {
+		/* no more TWI interrupts until the bus is cleared, that takes
+		 * about 100 us and is left to twi_service */
+		TWCR = 0;
+		clear_pending = 1;
+		current->twi_status = TWI_STATUS_TIMEOUT;
+		twi_engine_finish(current);
+	}
+}
+
+uint8_t twi_bus_clear(void) {
+
+	uint8_t i = 0;
+	uint8_t result = TWI_OK;
+
+	/* switch off the TWI, SDA and SCL are normal pins again */
+	TWCR = 0;
+
+	/* the pins are driven like open drain outputs: PORT is low, DDR 
+	 * set pulls the line low, DDR cleared releases it to the pullup */
+	PORTC &= ~((1 << TWI_SDA) | (1 << TWI_SCL));
+	DDRC &= ~((1 << TWI_SDA) | (1 << TWI_SCL));
+	_delay_us(TWI_BUS_CLEAR_DELAY_US);
+
+	/* a slave holding SDA low is in the middle of sending a byte, 
+	 * up to nine clock pulses let it finish the byte and the ACK bit,
+	 * see section 3.1.16 of the I2C specification (UM10204) */
+	for(i = 0; (i < 9) && !(PINC & (1 << TWI_SDA)); i++) {
+		DDRC |= (1 << TWI_SCL);
+		_delay_us(TWI_BUS_CLEAR_DELAY_US);
+		DDRC &= ~(1 << TWI_SCL);
+		_delay_us(TWI_BUS_CLEAR_DELAY_US);
+	}
+
+	/* send a STOP condition by hand, SDA rises while SCL is high */
+	DDRC |= (1 << TWI_SDA);
+	_delay_us(TWI_BUS_CLEAR_DELAY_US);
+	DDRC &= ~(1 << TWI_SDA);
+	_delay_us(TWI_BUS_CLEAR_DELAY_US);
+
+	if(!(PINC & (1 << TWI_SDA)) || !(PINC & (1 << TWI_SCL))) {
+		result = TWI_ERROR_BUS_STUCK;
+	}
+
+	/* give the pins back to the TWI */
+	TWCR = (1<<TWEN);
+
+	return result;
+}
+
+uint8_t twi_service(void) {
+
+	uint8_t sreg = SREG;
+	uint8_t result = TWI_OK;
+
+	if(!clear_pending) {
+		return TWI_OK;
+	}
+
+	/* the engine is off, twi_tick and twi_submit do not touch the
+	 * TWI while clear_pending is set */
+	result = twi_bus_clear();
+
+	cli();
+	clear_pending = 0;
+	/* transactions that were queued in the meantime */
+	if(queue_head != queue_tail) {
+		current = queue[queue_tail];
+		engine_ticks = TWI_TIMEOUT_TICKS;
+		TWCR = TWI_ISR_START;
+	}
+	SREG = sreg;
+
+	return result;
+}
+
+uint8_t twi_read_regs(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t len) {
+
+	uint8_t result = TWI_OK;
+
+	/* a bus clear left by the engine comes first */
+	twi_service();
+
+	twi_start();
+	if((result = twi_check(TW_START))) {
+		goto stop;
+	}
+	/* slave address, write operation */
+	twi_write((addr << 1) | TW_WRITE);
+	if((result = twi_check(TW_MT_SLA_ACK))) {
+		goto stop;
+	}
+	/* first register we want to read from */
+	twi_write(reg);
+	if((result = twi_check(TW_MT_DATA_ACK))) {
+		goto stop;
+	}
+	/* repeated start condition */
+	twi_start();
+	if((result = twi_check(TW_REP_START))) {
+		goto stop;
+	}
+	/* slave address, read operation */
+	twi_write((addr << 1) | TW_READ);
+	if((result = twi_check(TW_MR_SLA_ACK))) {
+		goto stop;
+	}
+
+	/* ACK every byte but the last one, the NACK tells the slave we
+	 * are done */
+	while(len > 1) {
+		*buf++ = twi_read_ack();
+		if((result = twi_check(TW_MR_DATA_ACK))) {
+			goto stop;
+		}
+		len--;
+	}
+	*buf = twi_read_nack();
+	if((result = twi_check(TW_MR_DATA_NACK))) {
+		goto stop;
+	}
+
+stop:
+
+	twi_finish(result);
+
+	return result;
+}
+
+uint8_t twi_write_regs(uint8_t addr, uint8_t reg, const uint8_t *buf, uint8_t len) {
+
+	uint8_t result = TWI_OK;
+
+	/* a bus clear left by the engine comes first */
+	twi_service();
+
+	twi_start();
+	if((result = twi_check(TW_START))) {
+		goto stop;
+	}
+	/* slave address, write operation */
+	twi_write((addr << 1) | TW_WRITE);
+	if((result = twi_check(TW_MT_SLA_ACK))) {
+		goto stop;
+	}
+	/* first register we want to write to */
+	twi_write(reg);
+	if((result = twi_check(TW_MT_DATA_ACK))) {
+		goto stop;
+	}
+	/* the slave increments the register address after each byte */
+	while(len) {
+		twi_write(*buf++);
+		if((result = twi_check(TW_MT_DATA_ACK))) {
+			goto stop;
+		}
+		len--;
+	}
+
+stop:
+
+	twi_finish(result);
+
+	return result;
+}
+
+uint8_t twi_submit(struct twi_transaction *transaction) {
+
+	uint8_t next = 0;
+	uint8_t sreg = SREG;
+	uint8_t ret = 0;
+
+	/* the ISR reads the queue and may be finishing a transaction 
+	 * right now, so keep it out until the queue is updated */
+	cli();
+
+	next = (queue_head + 1) & TWI_QUEUE_MASK;
+	if(next == queue_tail) {
+		/* queue is full, the transaction keeps its state */
+		ret = 1;
+	} else {
+		transaction->state = TWI_TRANSACTION_QUEUED;
+		transaction->twi_status = TW_NO_INFO;
+		queue[queue_head] = transaction;
+		/* the engine was idle if the queue was empty, send the start
+		 * condition, everything else happens in the ISR. From a 
+		 * callback twi_engine_finish does that. */
+		if((queue_head == queue_tail) && !clear_pending && !engine_finishing) {
+			current = transaction;
+			engine_ticks = TWI_TIMEOUT_TICKS;
+			TWCR = TWI_ISR_START;
+		}
+		queue_head = next;
+	}
+
+	SREG = sreg;
+
+	return ret;
+}
+
+uint8_t twi_busy(void) {
+	return (queue_head != queue_tail);
+}
+
+/*********************************************************************
+ * INTERRUPT SERVICE ROUTINE
+ *********************************************************************/
+/* NOTE: the transaction at the tail of the queue is the one on the 
+ * bus, it is removed once it is finished. Every state of the bus is
+ * reported by a status code in TWSR, refer to tables 21-3 and 21-4 
+ * of the ATMega328p datasheet. */
+ISR (TWI_vect) {
+
+	uint8_t status = TWSR & TW_STATUS_MASK;
+	/* local copy, saves reloading the volatile pointer */
+	struct twi_transaction *trans = current;
+
+	/* the bus made progress, restart the timeout */
+	engine_ticks = TWI_TIMEOUT_TICKS;
+
+	switch(status) {
+
+		case TW_START:					/* start condition sent, begin the transaction */
+														trans->state = TWI_TRANSACTION_BUSY;
+														data_index = 0;
+														/* only read if there is nothing to write */
+														if((trans->tx_len == 0) && (trans->rx_len != 0)) {
+															TWDR = (trans->addr << 1) | TW_READ;
+														} else {
+															TWDR = (trans->addr << 1) | TW_WRITE;
+														}
+														TWCR = TWI_ISR_NEXT;
+														return;
+		case TW_REP_START:			/* repeated start sent, switch to reading */
+														data_index = 0;
+														TWDR = (trans->addr << 1) | TW_READ;
+														TWCR = TWI_ISR_NEXT;
+														return;
+		case TW_MT_SLA_ACK:			/* slave or data byte acknowledged, */
+		case TW_MT_DATA_ACK:		/* write the next byte */
+														if(data_index < trans->tx_len) {
+															TWDR = trans->tx_data[data_index++];
+															TWCR = TWI_ISR_NEXT;
+															return;
+														}
+														if(trans->rx_len) {
+															TWCR = TWI_ISR_START;
+															return;
+														}
+														/* write only transaction is done */
+														break;
+		case TW_MR_DATA_ACK:		/* data received, ACK was sent */
+														trans->rx_data[data_index++] = TWDR;
+														/* fall through */
+		case TW_MR_SLA_ACK:			/* ACK all bytes but the last one */
+														TWCR = (data_index + 1 < trans->rx_len) ? TWI_ISR_ACK : TWI_ISR_NEXT;
+														return;
+		case TW_MR_DATA_NACK:		/* last byte received */
+														trans->rx_data[data_index++] = TWDR;
+														break;
+		default:								/* NACK from the slave, lost arbitration or 
+															 bus error, give up on this transaction.
+															 TWI_ISR_STOP releases the bus in all these
+															 cases, the callback can retry based on 
+															 twi_result(twi_status) */
+														trans->twi_status = status;
+														break;
+	}; /* switch case */
+
+	/* the transaction is finished */
+	twi_engine_finish(trans);
+}
+
 /*********************************************************************
  * EOF
  *********************************************************************/
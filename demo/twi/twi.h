@@ -10,6 +10,13 @@
  * Changelog:
  * [Date][Author]:[Change]
  * [14.09.2019][nmt]: initial commit
+ * [17.10.2026][nmt]: interrupt driven transaction engine
+ * [17.10.2026][nmt]: burst register read
+ * [17.10.2026][nmt]: burst register write
+ * [17.10.2026][nmt]: SCL setup from twi_cfg.h, twi_set_clock
+ * [17.10.2026][nmt]: timeouts, bus clear and error results
+ * [17.10.2026][nmt]: the engine leaves the bus clear to twi_service
+ * [17.10.2026][nmt]: submitting from a callback, full queue result
  *********************************************************************/
 
 #ifndef TWI_H
@@ -21,16 +28,85 @@
 #include <stdint.h>
 #include <util/twi.h>
 
+#include "twi_cfg.h"
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* returned by twi_status if the last wait timed out, the hardware 
+ * never reports it because the lower 3 bits of the status are 0 */
+#define TWI_STATUS_TIMEOUT 0x01
+
+/*********************************************************************
+ * TYPES
+ *********************************************************************/
+/* results of the TWI functions, TWI_OK is 0 so a result can be 
+ * checked like a boolean error flag */
+enum TWI_RESULTS {
+	TWI_OK,									/* success */
+	TWI_ERROR_TIMEOUT,			/* no progress within TWI_TIMEOUT_TICKS */
+	TWI_ERROR_NACK,					/* address or data not acknowledged, the 
+													 * slave is missing or busy, retry */
+	TWI_ERROR_ARBITRATION,	/* another master won the bus, retry */
+	TWI_ERROR_BUS,					/* illegal START or STOP on the bus */
+	TWI_ERROR_BUS_STUCK,		/* SDA or SCL still low after a bus clear */
+	TWI_ERROR_STATE					/* unexpected status code */
+};
+
+/* state of a transaction handed to the interrupt driven engine */
+enum TWI_TRANSACTION_STATES {
+	TWI_TRANSACTION_OK,				/* finished successfully */
+	TWI_TRANSACTION_QUEUED,		/* waiting in the queue */
+	TWI_TRANSACTION_BUSY,			/* currently on the bus */
+	TWI_TRANSACTION_ERROR			/* failed, see twi_status */
+};
+
+struct twi_transaction;
+
+/* called from the TWI interrupt once a transaction is finished, 
+ * keep it short. It may call twi_submit, the engine starts the new 
+ * transaction when the callback returns. */
+typedef void (*twi_callback_t)(struct twi_transaction *transaction);
+
+/* describes one complete transaction on the bus:
+ * tx_len > 0, rx_len = 0 -> pure write
+ * tx_len = 0, rx_len > 0 -> pure read
+ * tx_len > 0, rx_len > 0 -> write, repeated start, read 
+ * the buffers must stay valid until the transaction is finished */
+struct twi_transaction {
+	uint8_t addr;							/* 7-bit slave address, without R/W bit */
+	const uint8_t *tx_data;		/* data to write */
+	uint8_t tx_len;						/* number of bytes to write */
+	uint8_t *rx_data;					/* storage for the data to read */
+	uint8_t rx_len;						/* number of bytes to read */
+	twi_callback_t callback;	/* completion callback, may be NULL */
+	volatile uint8_t state;		/* see TWI_TRANSACTION_STATES */
+	volatile uint8_t twi_status;	/* TWI status code on error, 
+																 * see twi_result */
+};
+
 /*********************************************************************
  * FUNCTION PROTOTYPES
  *********************************************************************/
 
 /** 
  * @brief initializes the ATMega328p TWI interface
+ * NOTE: the SCL frequency is TWI_SCL_FREQ from twi_cfg.h
  * @return void 
  */
 void twi_init(void);
 
+/**
+ * @brief changes the SCL frequency, e.g. for a slower device
+ * NOTE: only call this while the bus is idle. The calculation is done
+ * at run time, use the TWI_TWBR/TWI_TWPS macros from twi_cfg.h for 
+ * constant frequencies if this is too slow.
+ * @param scl_freq SCL frequency in Hz, see TWI_SCL_* in twi_cfg.h
+ * @return 0 on success, 1 if the frequency can not be reached, the
+ * clock is not changed in this case
+ */
+uint8_t twi_set_clock(uint32_t scl_freq);
+
 /** 
  * @brief sends the start condition
  * @return void 
@@ -67,10 +143,102 @@ uint8_t twi_read_nack(void);
 /**
  * @brief gets the status of the TWI
  * NOTE: the status codes are defined in util/twi.h use them!
+ * TWI_STATUS_TIMEOUT is returned if the last operation timed out.
  * @return the status value 
  */
 uint8_t twi_status(void);
 
+/**
+ * @brief maps a status code to a result
+ * @param status a status code from twi_status or a transaction
+ * @return the result, see TWI_RESULTS, TWI_ERROR_STATE for status
+ * codes that are no error by themselves
+ */
+uint8_t twi_result(uint8_t status);
+
+/**
+ * @brief gets the status code of the step that failed in the last
+ * failed twi_read_regs or twi_write_regs
+ * @return the status code
+ */
+uint8_t twi_error_status(void);
+
+/**
+ * @brief time base for the timeouts, call this from a periodic timer
+ * interrupt, e.g. every millisecond
+ * NOTE: without it the blocking functions wait forever, like before.
+ * If a transaction of the interrupt driven engine times out, it
+ * finishes with TWI_STATUS_TIMEOUT and the engine stops until
+ * twi_service cleared the bus, the bus clear is too slow for the ISR.
+ * @return void
+ */
+void twi_tick(void);
+
+/**
+ * @brief releases a bus that is held by a slave, the TWI is switched
+ * off, SCL (pin C5) is toggled up to nine times until SDA (pin C4) is
+ * released, then a STOP condition is sent and the TWI switched on
+ * NOTE: takes about 100 us
+ * @return TWI_OK or TWI_ERROR_BUS_STUCK
+ */
+uint8_t twi_bus_clear(void);
+
+/**
+ * @brief clears the bus after a timeout of the engine and restarts
+ * the engine with the transactions queued in the meantime, call it
+ * regularly from the main loop or a task, twi_read_regs and
+ * twi_write_regs call it too
+ * NOTE: takes about 100 us if a bus clear is pending, else returns
+ * right away
+ * @return TWI_OK or TWI_ERROR_BUS_STUCK
+ */
+uint8_t twi_service(void);
+
+/**
+ * @brief reads consecutive registers of a slave in one transaction
+ * NOTE: START, SLA+W, reg, REPEATED START, SLA+R, len bytes, STOP.
+ * All bytes but the last are acknowledged, so the slave keeps 
+ * incrementing its register address. Uses the blocking functions.
+ * @param addr 7-bit slave address, without R/W bit
+ * @param reg address of the first register
+ * @param buf storage for the data, at least len bytes
+ * @param len number of registers to read range: [1 - 255]
+ * @return TWI_OK on success, see TWI_RESULTS and twi_error_status
+ * otherwise. After a timeout or bus error the bus is cleared.
+ */
+uint8_t twi_read_regs(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t len);
+
+/**
+ * @brief writes consecutive registers of a slave in one transaction
+ * NOTE: START, SLA+W, reg, len bytes, STOP. Uses the blocking functions.
+ * @param addr 7-bit slave address, without R/W bit
+ * @param reg address of the first register
+ * @param buf data to write
+ * @param len number of registers to write range: [0 - 255]
+ * @return TWI_OK on success, see TWI_RESULTS and twi_error_status
+ * otherwise. After a timeout or bus error the bus is cleared.
+ */
+uint8_t twi_write_regs(uint8_t addr, uint8_t reg, const uint8_t *buf, uint8_t len);
+
+/* NOTE: the functions below use the TWI interrupt, global interrupts
+ * must be enabled. Do not use the blocking functions above while the
+ * engine is busy. */
+
+/**
+ * @brief queues a transaction for the interrupt driven engine
+ * NOTE: the engine is started if the bus is idle
+ * @param transaction the transaction to run
+ * @return 0 if queued, 1 if the queue is full, the state of the 
+ * transaction is not changed then
+ */
+uint8_t twi_submit(struct twi_transaction *transaction);
+
+/**
+ * @brief checks if the interrupt driven engine is working
+ * @return 0 if idle, nonzero while transactions are running or queued
+ */
+uint8_t twi_busy(void);
+
 /*********************************************************************
  * EOF
  *********************************************************************/
@@ -0,0 +1,85 @@
+/*********************************************************************
+ * Twin Wire Interface (TWI) Driver - Configuration File
+ * Short Name: twi_cfg
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: Settings for the TWI, SCL setup based on F_CPU
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ * [17.10.2026][nmt]: timeout setting
+ *********************************************************************/
+
+#ifndef TWI_CFG_H
+#define TWI_CFG_H
+
+/* set CPU frequency for the SCL calculation */
+#ifndef F_CPU
+	#warning "TWI_CFG: F_CPU was undefined setting to 16 MHz"
+	#define F_CPU 16000000UL
+#endif
+
+/* common SCL frequencies in Hz */
+#define TWI_SCL_100KHZ 100000UL	/* standard mode */
+#define TWI_SCL_400KHZ 400000UL	/* fast mode, the maximum of the TWI */
+/* fastest frequency the TWI reaches with this F_CPU, at most 400 kHz.
+ * With TWBR = 0 the SCL frequency is F_CPU / 16 */
+#define TWI_SCL_FASTEST (((F_CPU / 16UL) < TWI_SCL_400KHZ) ? (F_CPU / 16UL) : TWI_SCL_400KHZ)
+
+/* SCL frequency set by twi_init, can also be set in the Makefile */
+#ifndef TWI_SCL_FREQ
+	#define TWI_SCL_FREQ TWI_SCL_FASTEST
+#endif
+
+/* NOTE: the SCL frequency is calculated as follows, see section 21.5.2
+ * of the ATmega328p datasheet:
+ * SCL = F_CPU / (16 + 2 * TWBR * 4^TWPS)
+ * The macros below solve this for TWBR, starting with the smallest 
+ * prescaler, which gives the finest steps. TWBR is rounded up, so the
+ * bus never runs faster than requested. They are constant for a 
+ * constant frequency, so they can be used in #if and cost nothing at
+ * run time. */
+
+/* clock cycles per SCL period, rounded up */
+#define TWI_TICKS(scl) ((F_CPU + (scl) - 1UL) / (scl))
+/* TWBR for a prescaler value of 1, 4, 16 or 64 */
+#define TWI_TWBR_PS(scl, ps) ((TWI_TICKS(scl) - 16UL + 2UL * (ps) - 1UL) / (2UL * (ps)))
+/* prescaler bits TWPS1:0 for a frequency */
+#define TWI_TWPS(scl) ((TWI_TWBR_PS(scl, 1UL) <= 255UL) ? 0 : \
+											 (TWI_TWBR_PS(scl, 4UL) <= 255UL) ? 1 : \
+											 (TWI_TWBR_PS(scl, 16UL) <= 255UL) ? 2 : 3)
+/* TWBR for a frequency */
+#define TWI_TWBR(scl) TWI_TWBR_PS(scl, 1UL << (2 * TWI_TWPS(scl)))
+
+/* a frequency can be reached if it needs at least 16 cycles and TWBR
+ * fits with the largest prescaler */
+#define TWI_SCL_VALID(scl) ((TWI_TICKS(scl) >= 16UL) && (TWI_TWBR_PS(scl, 64UL) <= 255UL))
+
+#if !TWI_SCL_VALID(TWI_SCL_FREQ)
+	#error "TWI_CFG: TWI_SCL_FREQ can not be reached at this F_CPU"
+#endif
+#if TWI_SCL_FREQ > TWI_SCL_400KHZ
+	#error "TWI_CFG: TWI_SCL_FREQ is above the 400 kHz of the TWI"
+#endif
+
+/* values used by twi_init */
+#define TWI_TWBR_VALUE TWI_TWBR(TWI_SCL_FREQ)
+#define TWI_TWPS_VALUE TWI_TWPS(TWI_SCL_FREQ)
+
+/* number of twi_tick calls a single step on the bus may take before
+ * it is aborted, with a 1 ms tick this is 1 - 2 ms, much more than 
+ * the 90 us of a byte at 100 kHz */
+#define TWI_TIMEOUT_TICKS 2
+
+/* number of transactions that can wait in the queue of the interrupt
+ * driven engine, must be a power of two */
+#define TWI_QUEUE_SIZE 4
+
+#if (TWI_QUEUE_SIZE & (TWI_QUEUE_SIZE - 1))
+	#error "TWI_CFG: TWI_QUEUE_SIZE must be a power of two"
+#endif
+
+#endif
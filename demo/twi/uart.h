@@ -10,6 +10,12 @@
  * Changelog:
  * [Date][Author]:[Change]
  * [15.09.2019][nmt]: initial commit
+ * [17.10.2026][nmt]: interrupt driven mode with ring buffers
+ * [17.10.2026][nmt]: zero copy transmit of caller owned buffers
+ * [17.10.2026][nmt]: sending from flash (PROGMEM)
+ * [17.10.2026][nmt]: line mode, the ISR assembles whole lines
+ * [17.10.2026][nmt]: RTS/CTS flow control and receive error counters
+ * [17.10.2026][nmt]: documented the length limit of uart_write_buffer
  *********************************************************************/
 
 #ifndef UART_H
@@ -38,6 +44,48 @@
  * register, and the receive complete flag (RXC0)  */
 #define UART_RECV_DONE ( UCSR0A & (1<<RXC0) )
 
+/* characters of the line mode */
+#define UART_LINE_BACKSPACE 0x08
+#define UART_LINE_DELETE 0x7f /* sent by most terminals for backspace */
+
+/* flags of a transmit descriptor */
+#define UART_TX_PROGMEM 0x01 /* data is in flash (PROGMEM) */
+
+/* most bytes of one transmit descriptor, len is 16 bit. A larger 
+ * buffer is queued as several descriptors */
+#define UART_TX_MAX_LEN 65535U
+
+/*********************************************************************
+ * TYPES
+ *********************************************************************/
+struct uart_tx_descriptor;
+
+/* called from the UART interrupt once the buffer of a descriptor is 
+ * sent and may be reused, keep it short */
+typedef void (*uart_tx_callback_t)(struct uart_tx_descriptor *descriptor);
+
+/* a buffer that is sent directly from where it is, without copying
+ * it into the transmit ring buffer. data and len are advanced while
+ * sending, the descriptor and the buffer must stay valid until busy
+ * is cleared */
+struct uart_tx_descriptor {
+	const uint8_t *data;						/* next byte to send */
+	uint16_t len;										/* bytes left, UART_TX_MAX_LEN at most */
+	uint8_t flags;									/* see UART_TX_PROGMEM */
+	uart_tx_callback_t callback;		/* completion callback, may be NULL */
+	volatile uint8_t busy;					/* 1 until the buffer is sent */
+	struct uart_tx_descriptor *next;	/* used by the driver */
+};
+
+/* receive errors, counted since uart_init or uart_clear_errors, each
+ * counter stops at 65535 */
+struct uart_errors {
+	uint16_t frame;		/* FE0, missing stop bit, wrong baudrate or noise */
+	uint16_t overrun;	/* DOR0, bytes lost before UDR0 was read */
+	uint16_t parity;	/* UPE0, only possible with parity enabled */
+	uint16_t dropped;	/* bytes lost because the ring buffer was full */
+};
+
 /*********************************************************************
  * FUNCTION PROTOTYPES
  *********************************************************************/
@@ -49,6 +97,19 @@
  */
 void uart_init(void);
 
+/* NOTE: with UART_ISR_MODE set in uart_cfg.h the functions below
+ * only access the ring buffers, the interrupts do the register work.
+ * Global interrupts must be enabled with sei() after uart_init(). The
+ * blocking functions wait for space/data in the ring buffers */
+
+/**
+ * @brief queues bytes for sending without blocking
+ * @param ui8_data data to send
+ * @param len number of bytes to send
+ * @return number of bytes copied into the transmit buffer [0 - len]
+ */
+uint8_t uart_write(const uint8_t *ui8_data, uint8_t len);
+
 /** 
  * @brief sends a single byte 
  * @param ui8_data the byte to send
@@ -56,6 +117,16 @@ void uart_init(void);
  */
 void uart_send(uint8_t ui8_data);
 
+#if !UART_LINE_MODE
+
+/**
+ * @brief takes received bytes without blocking
+ * @param ui8_data storage for the received bytes
+ * @param len maximum number of bytes to take
+ * @return number of bytes stored in ui8_data [0 - len]
+ */
+uint8_t uart_read(uint8_t *ui8_data, uint8_t len);
+
 /** 
  * @brief receives a single byte 
  * @return the received byte
@@ -70,6 +141,38 @@ uint8_t uart_recv(void);
  */
 void uart_recv_alt(uint8_t *ui8_data);
 
+#else
+
+/* NOTE: in line mode the receive interrupt collects the characters 
+ * of a line in one of two buffers. A '\r' or '\n' completes the line 
+ * and hands the buffer to the main loop, the interrupt continues in 
+ * the other buffer. Backspace and delete remove the last character. 
+ * Empty lines are ignored, lines longer than UART_LINE_SIZE - 1 and 
+ * lines completed while the main loop still holds the previous one 
+ * are dropped and counted. The single byte receive functions do not 
+ * exist in this mode. */
+
+/**
+ * @brief returns the next complete line without blocking
+ * @return zero terminated line without the line end, 0 if there is 
+ * none, valid until uart_line_release
+ */
+char *uart_line_get(void);
+
+/**
+ * @brief hands the line of uart_line_get back to the interrupt
+ * @return void
+ */
+void uart_line_release(void);
+
+/**
+ * @brief number of lines dropped so far
+ * @return dropped lines, stops at 65535
+ */
+uint16_t uart_line_dropped(void);
+
+#endif
+
 /** 
  * @brief sends multiple bytes of data
  * @param ui8_data data to send
@@ -78,6 +181,57 @@ void uart_recv_alt(uint8_t *ui8_data);
  */
 void uart_send_string(uint8_t *ui8_data, uint8_t len);
 
+/* NOTE: constant strings and tables can stay in flash and be sent with
+ * the _P functions below, this saves the SRAM the compiler would 
+ * otherwise use for a copy. Use PSTR("...") or PROGMEM from 
+ * avr/pgmspace.h to put them there. */
+
+/**
+ * @brief sends multiple bytes of data stored in flash
+ * @param ui8_data data to send, address in flash
+ * @param len number of bytes to send
+ * @return void
+ */
+void uart_send_P(const uint8_t *ui8_data, uint8_t len);
+
+/**
+ * @brief sends a zero terminated string stored in flash
+ * @param str the string, address in flash, e.g. PSTR("text")
+ * @return void
+ */
+void uart_print_P(const char *str);
+
+/**
+ * @brief queues a caller owned buffer for sending without blocking
+ * NOTE: the interrupt takes the bytes straight from the buffer, up to
+ * UART_TX_MAX_LEN (65535, not 64 KiB) bytes per descriptor, split 
+ * longer buffers. Flash data must lie in the first 64 KiB, it is read
+ * with pgm_read_byte. Descriptors are sent in order, but 
+ * only once the transmit ring buffer is empty, so bytes queued with 
+ * uart_write later may overtake them. Without UART_ISR_MODE the 
+ * buffer is sent right away and the function blocks.
+ * @param descriptor describes the buffer, must not be queued already
+ * @return void
+ */
+void uart_write_buffer(struct uart_tx_descriptor *descriptor);
+
+/* NOTE: a byte with a frame or parity error is still delivered by 
+ * uart_read and uart_recv, the protocol on top (e.g. a CRC) has to 
+ * reject it. In line mode the whole line is dropped. */
+
+/**
+ * @brief copies the receive error counters
+ * @param errors storage for the counters
+ * @return void
+ */
+void uart_get_errors(struct uart_errors *errors);
+
+/**
+ * @brief sets all receive error counters to 0
+ * @return void
+ */
+void uart_clear_errors(void);
+
 
 
 /*********************************************************************
@@ -0,0 +1,94 @@
+/*********************************************************************
+ * Command Dispatcher - C File
+ * Short Name: cmd
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: looks up text commands like "pwm 128" in a table and
+ *							calls their handler
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/pgmspace.h>
+#include <string.h>
+
+#include "cmd.h"
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+static char *cmd_skip_spaces(char *str) {
+	while(*str == ' ') {
+		str++;
+	}
+	return str;
+}
+
+uint8_t cmd_dispatch(const struct cmd_entry *table, uint8_t count, char *line) {
+
+	uint8_t i = 0;
+	char *name = cmd_skip_spaces(line);
+	char *args = name;
+	cmd_handler handler = 0;
+
+	if(*name == '\0') {
+		return CMD_ERROR_EMPTY;
+	}
+
+	/* cut the name off the arguments */
+	while((*args != ' ') && (*args != '\0')) {
+		args++;
+	}
+	if(*args == ' ') {
+		*args++ = '\0';
+	}
+	args = cmd_skip_spaces(args);
+
+	for(i = 0; i < count; i++) {
+		/* the table is in flash, compare with the _P functions */
+		if(strncmp_P(name, table[i].name, CMD_NAME_SIZE) == 0) {
+			handler = (cmd_handler)pgm_read_ptr(&table[i].handler);
+			return handler(args);
+		}
+	}
+
+	return CMD_ERROR_UNKNOWN;
+}
+
+uint8_t cmd_parse_u16(char **args, uint16_t *value) {
+
+	char *str = *args;
+	uint32_t number = 0;
+
+	if((*str < '0') || (*str > '9')) {
+		return CMD_ERROR_ARGUMENT;
+	}
+
+	while((*str >= '0') && (*str <= '9')) {
+		number = (number * 10) + (*str - '0');
+		if(number > 0xffff) {
+			return CMD_ERROR_ARGUMENT;
+		}
+		str++;
+	}
+	/* the number has to end here */
+	if((*str != ' ') && (*str != '\0')) {
+		return CMD_ERROR_ARGUMENT;
+	}
+
+	*value = (uint16_t)number;
+	*args = cmd_skip_spaces(str);
+
+	return CMD_OK;
+}
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
@@ -0,0 +1,91 @@
+/*********************************************************************
+ * Command Dispatcher - Header File
+ * Short Name: cmd
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: looks up text commands like "pwm 128" in a table and
+ *							calls their handler
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * NOTES:	a command is a name followed by optional arguments, 
+ *				separated by spaces. The table is kept in flash, define 
+ *				it with PROGMEM:
+ *
+ *				static const struct cmd_entry commands[] PROGMEM = {
+ *					{ "pwm", cmd_pwm },
+ *					...
+ *				};
+ *
+ *				The lines usually come from uart_line_get in line mode.
+ *********************************************************************/
+
+#ifndef CMD_H
+#define CMD_H
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <stdint.h>
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* maximum length of a command name including the terminating zero */
+#define CMD_NAME_SIZE 8
+
+/*********************************************************************
+ * TYPES
+ *********************************************************************/
+/* results of cmd_dispatch, the handlers return these as well */
+enum CMD_RESULTS {
+	CMD_OK,
+	CMD_ERROR_EMPTY,		/* the line has no command */
+	CMD_ERROR_UNKNOWN,	/* the command is not in the table */
+	CMD_ERROR_ARGUMENT	/* missing or invalid argument */
+};
+
+/* called with the arguments of the command, leading spaces are 
+ * already skipped, returns one of CMD_RESULTS */
+typedef uint8_t (*cmd_handler)(char *args);
+
+/* an entry of the command table */
+struct cmd_entry {
+	char name[CMD_NAME_SIZE];
+	cmd_handler handler;
+};
+
+/*********************************************************************
+ * FUNCTION PROTOTYPES
+ *********************************************************************/
+
+/**
+ * @brief finds the command of a line and calls its handler
+ * NOTE: the line is modified, the name gets a terminating zero
+ * @param table the command table, address in flash
+ * @param count number of entries of the table
+ * @param line the zero terminated line
+ * @return the result of the handler or one of CMD_RESULTS
+ */
+uint8_t cmd_dispatch(const struct cmd_entry *table, uint8_t count, char *line);
+
+/**
+ * @brief parses an unsigned decimal argument
+ * @param args the arguments, moved behind the number and the spaces
+ * that follow it
+ * @param value storage for the number
+ * @return CMD_OK or CMD_ERROR_ARGUMENT if there is no number or it 
+ * does not fit in 16 bits
+ */
+uint8_t cmd_parse_u16(char **args, uint16_t *value);
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
+#endif
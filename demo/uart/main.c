@@ -3,58 +3,217 @@
  * Short Name: uart
  * Author: nmt @ NT-COM
  * Date: 15.06.2019
- * Description: a simple echo program that sends a welcome string
+ * Description: a simple command line that sends a welcome string
  *********************************************************************/
 
 /*********************************************************************
  * Changelog:
  * [Date][Author]:[Change]
  * [15.09.2019][nmt]: initial commit
+ * [17.10.2026][nmt]: enable interrupts for the interrupt driven UART
+ * [17.10.2026][nmt]: simavr support, see the sim target
+ * [17.10.2026][nmt]: strings are sent from flash
+ * [17.10.2026][nmt]: echo prints the character code in hex and decimal
+ * [17.10.2026][nmt]: the echo is replaced by a command line, the 
+ *										receive interrupt assembles the lines
+ * [17.10.2026][nmt]: get prints the receive error counters
+ *********************************************************************/
+
+/*********************************************************************
+ * Usage:
+ *					Send lines terminated with CR and/or LF at 9600 baud,
+ *					the terminal has to echo locally. Commands:
+ *
+ *					help				lists the commands
+ *					get					prints the settings and receive errors
+ *					rate <hz>		sample rate [1 - 1000]
+ *					pwm <duty>	PWM duty on pin D6 (OC0A) [0 - 255]
+ *					twi <khz>		TWI clock [10 - 400]
+ *
+ *					Every command is answered with "ok" or "error: ...".
+ *					Only the PWM duty is applied in this demo, the sample 
+ *					rate and TWI clock are just stored, the TWI demo 
+ *					would apply them with MPU6050_SMPLRT_DIV and 
+ *					twi_set_clock.
  *********************************************************************/
 
 #include <avr/io.h>
-#include <util/delay.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <avr/sleep.h>
 
 #include "uart.h"
+#include "uart_fmt.h"
+#include "cmd.h"
+
+/* NOTE: only used for "make sim", tells simavr which MCU and clock to
+ * use and which registers to record in uart.vcd */
+#ifdef SIMAVR
+#include "avr_mcu_section.h"
+AVR_MCU(F_CPU, "atmega328p");
+AVR_MCU_VCD_FILE("uart.vcd", 1000);
+const struct avr_mmcu_vcd_trace_t simavr_trace[] _MMCU_ = {
+	{ AVR_MCU_VCD_SYMBOL("UDR0"), .mask = 0xff, .what = (void*)&UDR0, },
+};
+#endif
+
+#if !UART_LINE_MODE
+	#error "MAIN: build with UART_LINE_MODE=1, see the Makefile"
+#endif
 
-/* uncomment if you want to use the alternative receive function */
-/* #define RECV_ALT 1 */
+/* runtime settings, changed by the commands */
+struct settings {
+	uint16_t sample_rate;	/* Hz */
+	uint8_t pwm_duty;			/* [0 - 255] */
+	uint16_t twi_khz;			/* kHz */
+};
+
+static struct settings settings = { 100, 0, 400 };
+
+/* the command handlers */
+static uint8_t cmd_help(char *args);
+static uint8_t cmd_get(char *args);
+static uint8_t cmd_rate(char *args);
+static uint8_t cmd_pwm(char *args);
+static uint8_t cmd_twi(char *args);
+
+/* the command table, kept in flash */
+static const struct cmd_entry commands[] PROGMEM = {
+	{ "help", cmd_help },
+	{ "get", cmd_get },
+	{ "rate", cmd_rate },
+	{ "pwm", cmd_pwm },
+	{ "twi", cmd_twi }
+};
+
+#define COMMANDS (sizeof(commands) / sizeof(commands[0]))
+
+/* parses the single number argument of a command and checks its 
+ * range */
+static uint8_t parse_setting(char *args, uint16_t min, uint16_t max, uint16_t *value) {
+	if(cmd_parse_u16(&args, value) != CMD_OK) {
+		return CMD_ERROR_ARGUMENT;
+	}
+	if((*args != '\0') || (*value < min) || (*value > max)) {
+		return CMD_ERROR_ARGUMENT;
+	}
+	return CMD_OK;
+}
+
+static uint8_t cmd_help(char *args) {
+
+	uint8_t i = 0;
+
+	for(i = 0; i < COMMANDS; i++) {
+		uart_print_P(commands[i].name);
+		uart_send('\n');
+	}
+	return CMD_OK;
+}
+
+static uint8_t cmd_get(char *args) {
+
+	struct uart_errors errors;
+
+	uart_get_errors(&errors);
+
+	uart_print_P(PSTR("rate "));
+	uart_print_u16(settings.sample_rate);
+	uart_print_P(PSTR("\npwm "));
+	uart_print_u16(settings.pwm_duty);
+	uart_print_P(PSTR("\ntwi "));
+	uart_print_u16(settings.twi_khz);
+	uart_print_P(PSTR("\ndropped lines "));
+	uart_print_u16(uart_line_dropped());
+	uart_print_P(PSTR("\nframe errors "));
+	uart_print_u16(errors.frame);
+	uart_print_P(PSTR("\noverruns "));
+	uart_print_u16(errors.overrun);
+	uart_print_P(PSTR("\nparity errors "));
+	uart_print_u16(errors.parity);
+	uart_send('\n');
+	return CMD_OK;
+}
+
+static uint8_t cmd_rate(char *args) {
+	return parse_setting(args, 1, 1000, &settings.sample_rate);
+}
+
+static uint8_t cmd_pwm(char *args) {
+
+	uint16_t duty = 0;
+
+	if(parse_setting(args, 0, 255, &duty) != CMD_OK) {
+		return CMD_ERROR_ARGUMENT;
+	}
+	settings.pwm_duty = (uint8_t)duty;
+	OCR0A = settings.pwm_duty;
+	return CMD_OK;
+}
+
+static uint8_t cmd_twi(char *args) {
+	return parse_setting(args, 10, 400, &settings.twi_khz);
+}
 
 /* MAIN */
 int main () {
 
-	uint8_t ui8_data = 0x00; /* stores the received data */
-	uint8_t test_string[7] = { 'n', 't', '-', 'c', 'o', 'm', '\n' };
-	uint8_t echo_string[6] = { 'e', 'c', 'h', 'o', ':', ' ' };
-	uint8_t newline = '\n';
+	char *line = 0;
 
 	/* initialization of the interface */
 	uart_init();
+
+	/* fast PWM on OC0A (pin D6), non-inverting, prescaler 64 */
+	DDRD |= (1 << DDD6);
+	TCCR0A = (1 << COM0A1) | (1 << WGM01) | (1 << WGM00);
+	OCR0A = settings.pwm_duty;
+	TCCR0B = (1 << CS01) | (1 << CS00);
+
+	set_sleep_mode(SLEEP_MODE_IDLE);
+
+	/* the interrupt driven UART needs global interrupts */
+	sei();
 	
 	/* send a string to check if this function works */
-	uart_send_string(&test_string[0], 7);
+	uart_print_P(PSTR("nt-com\n"));
 	
 	while(1) {
 		
 		/* SUPERLOOP */	
-		/* realizes a single character echo */
-		
-		/* chooses between the recv and alternative recv functions */
-		#ifndef RECV_ALT
-			ui8_data = uart_recv();
-		#else
-			uart_recv_alt(&ui8_data);
-		#endif
-		
-		/* send a prompt indicating that the echoed character will
-		 * follow */
-		uart_send_string(&echo_string[0], 6);
-		/* send the data we received */
-		uart_send(ui8_data);
-		/* send a newline so everything looks nicer */
-		uart_send(newline);
+
+		/* sleep until the receive interrupt completes a line, the 
+		 * check and sleep_cpu must not be interrupted, otherwise a 
+		 * line completed in between would not wake us. sei takes 
+		 * effect after the next instruction, so no interrupt fits 
+		 * between it and sleep_cpu. */
+		cli();
+		line = uart_line_get();
+		if(!line) {
+			sleep_enable();
+			sei();
+			sleep_cpu();
+			sleep_disable();
+			continue;
+		}
+		sei();
+
+		switch(cmd_dispatch(commands, COMMANDS, line)) {
+			case CMD_OK:
+				uart_print_P(PSTR("ok\n"));
+				break;
+			case CMD_ERROR_UNKNOWN:
+				uart_print_P(PSTR("error: unknown command\n"));
+				break;
+			case CMD_ERROR_ARGUMENT:
+				uart_print_P(PSTR("error: argument\n"));
+				break;
+			default:
+				break;
+		}
+
+		/* the interrupt may fill this buffer again */
+		uart_line_release();
 
 	} /* while(1)*/
 
 }
-
@@ -10,19 +10,116 @@
  * Changelog:
  * [Date][Author]:[Change]
  * [15.09.2019][nmt]: initial commit
+ * [17.10.2026][nmt]: interrupt driven mode with ring buffers
+ * [17.10.2026][nmt]: double speed mode chosen by uart_cfg.h
+ * [17.10.2026][nmt]: zero copy transmit of caller owned buffers
+ * [17.10.2026][nmt]: sending from flash (PROGMEM)
+ * [17.10.2026][nmt]: line mode, the ISR assembles whole lines
+ * [17.10.2026][nmt]: RTS/CTS flow control and receive error counters
  *********************************************************************/
 
 /*********************************************************************
  * LIBRARIES
  *********************************************************************/
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
 #include "uart.h"
 
 /*********************************************************************
- * FUNCTION PROTOTYPES
+ * MACROS
+ *********************************************************************/
+#define UART_TX_MASK (UART_TX_BUFFER_SIZE - 1)
+#define UART_RX_MASK (UART_RX_BUFFER_SIZE - 1)
+
+/* error flags of UCSR0A that belong to the byte in UDR0 */
+#define UART_RX_ERRORS ((1<<FE0) | (1<<DOR0) | (1<<UPE0))
+
+#if UART_FLOW_CONTROL
+/* both lines are active low */
+#define UART_CTS_READY ( !(UART_CTS_PIN & (1<<UART_CTS_BIT)) )
+#define UART_RTS_STOP() ( UART_RTS_PORT |= (1<<UART_RTS_BIT) )
+#define UART_RTS_GO() ( UART_RTS_PORT &= ~(1<<UART_RTS_BIT) )
+/* fill level of the receive ring buffer that stops the host */
+#define UART_RTS_HIGH (UART_RX_BUFFER_SIZE - 1 - UART_RTS_MARGIN)
+#define UART_RTS_LOW (UART_RX_BUFFER_SIZE / 2)
+#endif
+
+/*********************************************************************
+ * VARIABLES
+ *********************************************************************/
+/* receive error counters, written in the receive interrupt or by the
+ * polling receive functions */
+static volatile struct uart_errors rx_errors;
+
+#if UART_ISR_MODE
+/* NOTE: both ring buffers have exactly one producer and one consumer.
+ * The producer only writes the head, the consumer only writes the
+ * tail, so no locking is needed as long as the 8 bit indices are 
+ * read and written in one access. One slot always stays empty to 
+ * tell a full buffer from an empty one. */
+
+/* transmit ring buffer, filled by uart_write, drained by the ISR */
+static volatile uint8_t tx_buffer[UART_TX_BUFFER_SIZE];
+static volatile uint8_t tx_head = 0;
+static volatile uint8_t tx_tail = 0;
+
+#if !UART_LINE_MODE
+/* receive ring buffer, filled by the ISR, drained by uart_read */
+static volatile uint8_t rx_buffer[UART_RX_BUFFER_SIZE];
+static volatile uint8_t rx_head = 0;
+static volatile uint8_t rx_tail = 0;
+#else
+/* line buffers, the ISR fills line_buffer[line_fill], the other one 
+ * belongs to the main loop while line_ready is set */
+static volatile char line_buffer[2][UART_LINE_SIZE];
+static volatile uint8_t line_fill = 0;
+static volatile uint8_t line_ready = 0;
+/* only used by the ISR */
+static uint8_t line_len = 0;
+static uint8_t line_discard = 0; /* overflow or receive error */
+static volatile uint16_t line_dropped = 0;
+#endif
+
+/* queue of caller owned buffers, linked through their next pointer,
+ * uart_write_buffer appends at the tail, the ISR removes the head */
+static struct uart_tx_descriptor * volatile desc_head = 0;
+static struct uart_tx_descriptor * volatile desc_tail = 0;
+#endif
+
+/*********************************************************************
+ * FUNCTIONS
  *********************************************************************/
 
 /* NOTE: to follow along below, refer to the ATmega328p datasheet */
 
+static void uart_count(volatile uint16_t *counter) {
+	if(*counter != 0xffff) {
+		(*counter)++;
+	}
+}
+
+/* counts the errors of the byte in UDR0, status is UCSR0A read before 
+ * UDR0, returns 1 if the byte itself is corrupt */
+static uint8_t uart_check_errors(uint8_t status) {
+
+	if(!(status & UART_RX_ERRORS)) {
+		return 0;
+	}
+	/* the byte is fine, but at least one before it was lost */
+	if(status & (1<<DOR0)) {
+		uart_count(&rx_errors.overrun);
+	}
+	if(status & (1<<FE0)) {
+		uart_count(&rx_errors.frame);
+	}
+	if(status & (1<<UPE0)) {
+		uart_count(&rx_errors.parity);
+	}
+
+	return (status & ((1<<FE0) | (1<<UPE0))) ? 1 : 0;
+}
+
 /* initializes the UART */
 void uart_init() {
 	
@@ -32,19 +129,174 @@ void uart_init() {
 	UBRR0H = (uint8_t)(PRESCALE_VALUE>>8);
 	/* the low register for the baudrate */
 	UBRR0L = (uint8_t)(PRESCALE_VALUE);
+
+	/* uart_cfg.h decides if double speed gives the smaller error */
+#if UART_USE_2X
+	UCSR0A |= (1<<U2X0);
+#else
+	UCSR0A &= ~(1<<U2X0);
+#endif
 	
 	/* enable reception and sending */
+#if UART_ISR_MODE
+	/* additionally enable the receive complete interrupt, the data
+	 * register empty interrupt is only enabled while there is 
+	 * something to send, see uart_write */
+	UCSR0B = (1<<RXEN0) | (1<<TXEN0) | (1<<RXCIE0);
+#else
 	UCSR0B = (1<<RXEN0) | (1<<TXEN0);
+#endif
 	/* set the character size to 8 bits, meaning we send and receive 
 	 * bytes */ 
 	UCSR0C = ((1<<UCSZ00) | (1<<UCSZ01));
+
+#if UART_FLOW_CONTROL
+	/* RTS low, we are ready to receive */
+	UART_RTS_DDR |= (1<<UART_RTS_BIT);
+	UART_RTS_GO();
+	/* CTS as input with pull-up, an unconnected CTS stops sending */
+	UART_CTS_DDR &= ~(1<<UART_CTS_BIT);
+	UART_CTS_PORT |= (1<<UART_CTS_BIT);
+	/* every edge of CTS calls the pin change interrupt */
+	UART_CTS_PCMSK |= (1<<UART_CTS_PCINT);
+	PCICR |= (1<<UART_CTS_PCIE);
+#endif
+
+	uart_clear_errors();
 	
 	/* take a look at clause 19.10.4, you will notice we are using
 	 * 8N1 with the UART - 8 bits, no parity, 1 stop bit */	
 }
 
+#if UART_ISR_MODE
+
+/* queues data in the transmit ring buffer */
+uint8_t uart_write(const uint8_t *ui8_data, uint8_t len) {
+
+	uint8_t count = 0;
+	uint8_t head = tx_head;
+	uint8_t next = 0;
+
+	while(count < len) {
+		next = (head + 1) & UART_TX_MASK;
+		/* stop if the buffer is full */
+		if(next == tx_tail) {
+			break;
+		}
+		tx_buffer[head] = ui8_data[count++];
+		head = next;
+	}
+
+	if(count) {
+		/* publish the new head only after the data is stored */
+		tx_head = head;
+		/* start sending, the ISR fires as soon as UDR0 is empty */
+		UCSR0B |= (1<<UDRIE0);
+	}
+
+	return count;
+}
+
+#if !UART_LINE_MODE
+
+/* takes data out of the receive ring buffer */
+uint8_t uart_read(uint8_t *ui8_data, uint8_t len) {
+
+	uint8_t count = 0;
+	uint8_t tail = rx_tail;
+
+	while((count < len) && (tail != rx_head)) {
+		ui8_data[count++] = rx_buffer[tail];
+		tail = (tail + 1) & UART_RX_MASK;
+	}
+
+	/* release the slots only after the data is copied */
+	rx_tail = tail;
+
+#if UART_FLOW_CONTROL
+	/* let the host continue once half of the buffer is free */
+	if(((rx_head - tail) & UART_RX_MASK) <= UART_RTS_LOW) {
+		UART_RTS_GO();
+	}
+#endif
+
+	return count;
+}
+
+/* the blocking functions are wrappers around the ring buffers */
+
+/* receives a single character */
+uint8_t uart_recv() {
+	uint8_t ui8_data = 0x00;
+	while(!uart_read(&ui8_data, 1));
+	return ui8_data;
+}
+/* alternative receive function */
+void uart_recv_alt(uint8_t *ui8_data) {
+	while(!uart_read(ui8_data, 1));
+}
+
+#else
+
+char *uart_line_get(void) {
+	if(!line_ready) {
+		return 0;
+	}
+	/* line_fill does not change while line_ready is set, the main 
+	 * loop owns the buffer, so volatile can be dropped */
+	return (char *)line_buffer[line_fill ^ 1];
+}
+
+void uart_line_release(void) {
+	line_ready = 0;
+#if UART_FLOW_CONTROL
+	UART_RTS_GO();
+#endif
+}
+
+uint16_t uart_line_dropped(void) {
+
+	uint8_t sreg = SREG;
+	uint16_t dropped = 0;
+
+	/* 16 bit, the ISR could change it between the two byte reads */
+	cli();
+	dropped = line_dropped;
+	SREG = sreg;
+
+	return dropped;
+}
+
+#endif
+
+/* sends a single character */
+void uart_send(uint8_t ui8_data) {
+	while(!uart_write(&ui8_data, 1));
+}
+
+#else
+
 /* for sending and receiving, check the comments of the macros 
  * in uart.h for a detailed summary */
+
+/* without the interrupts we can only hand over one byte at a time */
+uint8_t uart_write(const uint8_t *ui8_data, uint8_t len) {
+	if(len && UART_SEND_DONE) {
+		UDR0 = *ui8_data;
+		return 1;
+	}
+	return 0;
+}
+
+uint8_t uart_read(uint8_t *ui8_data, uint8_t len) {
+	if(len && UART_RECV_DONE) {
+		/* the error flags are only valid before UDR0 is read */
+		uart_check_errors(UCSR0A);
+		*ui8_data = UDR0;
+		return 1;
+	}
+	return 0;
+}
  
 /* sends a single character */
 void uart_send(uint8_t ui8_data) {
@@ -56,26 +308,287 @@ void uart_send(uint8_t ui8_data) {
 uint8_t uart_recv() {
 	uint8_t ui8_data = 0x00;
 	while(!UART_RECV_DONE);
+	uart_check_errors(UCSR0A);
 	ui8_data = UDR0;
 	return ui8_data;
 }
 /* alternative receive function */
 void uart_recv_alt(uint8_t *ui8_data) {
 	while(!UART_RECV_DONE);
+	uart_check_errors(UCSR0A);
 	*ui8_data = UDR0;
 }
 
+#endif
+
 /* sends a string */
 void uart_send_string(uint8_t *ui8_data, uint8_t len) {
 	
-	/* pass each byte to the send function, to send a string 
-	 * we send it byte by byte */
+	uint8_t sent = 0;
+
+	/* hand the data to uart_write until everything is queued, in
+	 * interrupt mode this copies whole chunks into the ring buffer */
 	while(len) {
-		uart_send( *(ui8_data++) );
+		sent = uart_write(ui8_data, len);
+		ui8_data += sent;
+		len -= sent;
+	}
+}
+
+/* sends data from flash */
+void uart_send_P(const uint8_t *ui8_data, uint8_t len) {
+	/* flash can not be read like RAM, every byte is fetched with 
+	 * pgm_read_byte (LPM instruction) */
+	while(len) {
+		uart_send(pgm_read_byte(ui8_data++));
 		len--;
 	}
 }
 
+/* sends a string from flash */
+void uart_print_P(const char *str) {
+
+	uint8_t ui8_data = pgm_read_byte(str++);
+
+	while(ui8_data) {
+		uart_send(ui8_data);
+		ui8_data = pgm_read_byte(str++);
+	}
+}
+
+void uart_get_errors(struct uart_errors *errors) {
+
+	uint8_t sreg = SREG;
+
+	cli();
+	errors->frame = rx_errors.frame;
+	errors->overrun = rx_errors.overrun;
+	errors->parity = rx_errors.parity;
+	errors->dropped = rx_errors.dropped;
+	SREG = sreg;
+}
+
+void uart_clear_errors(void) {
+
+	uint8_t sreg = SREG;
+
+	cli();
+	rx_errors.frame = 0;
+	rx_errors.overrun = 0;
+	rx_errors.parity = 0;
+	rx_errors.dropped = 0;
+	SREG = sreg;
+}
+
+#if UART_ISR_MODE
+
+void uart_write_buffer(struct uart_tx_descriptor *descriptor) {
+
+	uint8_t sreg = SREG;
+
+	descriptor->next = 0;
+
+	if(descriptor->len == 0) {
+		descriptor->busy = 0;
+		if(descriptor->callback) {
+			descriptor->callback(descriptor);
+		}
+		return;
+	}
+	descriptor->busy = 1;
+
+	/* the ISR removes descriptors from the queue */
+	cli();
+	if(desc_tail) {
+		desc_tail->next = descriptor;
+	} else {
+		desc_head = descriptor;
+	}
+	desc_tail = descriptor;
+	UCSR0B |= (1<<UDRIE0);
+	SREG = sreg;
+}
+
+#else
+
+void uart_write_buffer(struct uart_tx_descriptor *descriptor) {
+
+	descriptor->busy = 1;
+
+	while(descriptor->len) {
+		if(descriptor->flags & UART_TX_PROGMEM) {
+			uart_send(pgm_read_byte(descriptor->data));
+		} else {
+			uart_send(*descriptor->data);
+		}
+		descriptor->data++;
+		descriptor->len--;
+	}
+
+	descriptor->busy = 0;
+	if(descriptor->callback) {
+		descriptor->callback(descriptor);
+	}
+}
+
+#endif
+
+/*********************************************************************
+ * INTERRUPT SERVICE ROUTINES
+ *********************************************************************/
+#if UART_ISR_MODE
+
+/* data register empty, hand over the next byte */
+ISR (USART_UDRE_vect) {
+	uint8_t tail = tx_tail;
+
+	struct uart_tx_descriptor *descriptor = 0;
+
+#if UART_FLOW_CONTROL
+	/* the host can not take more, the CTS pin change interrupt starts 
+	 * sending again. NOTE: up to two bytes already in the UART are 
+	 * still sent. */
+	if(!UART_CTS_READY) {
+		UCSR0B &= ~(1<<UDRIE0);
+		return;
+	}
+#endif
+
+	if(tail != tx_head) {
+		UDR0 = tx_buffer[tail];
+		tx_tail = (tail + 1) & UART_TX_MASK;
+		return;
+	}
+
+	/* the ring buffer is empty, continue with the caller buffers */
+	descriptor = desc_head;
+	if(descriptor) {
+		if(descriptor->flags & UART_TX_PROGMEM) {
+			UDR0 = pgm_read_byte(descriptor->data);
+		} else {
+			UDR0 = *descriptor->data;
+		}
+		descriptor->data++;
+		if(--descriptor->len == 0) {
+			/* buffer done, hand it back */
+			desc_head = descriptor->next;
+			if(!desc_head) {
+				desc_tail = 0;
+			}
+			descriptor->busy = 0;
+			if(descriptor->callback) {
+				descriptor->callback(descriptor);
+			}
+		}
+		return;
+	}
+
+	/* nothing left, disable the interrupt until uart_write or 
+	 * uart_write_buffer queue more data */
+	UCSR0B &= ~(1<<UDRIE0);
+}
+
+#if !UART_LINE_MODE
+
+/* receive complete, store the byte */
+ISR (USART_RX_vect) {
+	/* UCSR0A first, its error flags belong to the byte in UDR0. UDR0 
+	 * must be read in any case to clear the interrupt flag */
+	uint8_t status = UCSR0A;
+	uint8_t ui8_data = UDR0;
+	uint8_t next = (rx_head + 1) & UART_RX_MASK;
+
+	uart_check_errors(status);
+
+	/* drop the byte if the buffer is full */
+	if(next != rx_tail) {
+		rx_buffer[rx_head] = ui8_data;
+		rx_head = next;
+	} else {
+		uart_count(&rx_errors.dropped);
+	}
+
+#if UART_FLOW_CONTROL
+	if(((next - rx_tail) & UART_RX_MASK) >= UART_RTS_HIGH) {
+		UART_RTS_STOP();
+	}
+#endif
+}
+
+#else
+
+/* receive complete, add the byte to the current line */
+ISR (USART_RX_vect) {
+	uint8_t status = UCSR0A;
+	uint8_t ui8_data = UDR0;
+
+	/* a corrupt byte or a lost one spoils the whole line */
+	if(uart_check_errors(status) || (status & (1<<DOR0))) {
+		line_discard = 1;
+	}
+
+	switch(ui8_data) {
+		case '\r':
+		case '\n':
+			/* ignore empty lines, this also skips the \n of \r\n */
+			if(!line_len && !line_discard) {
+				break;
+			}
+			if(line_discard || line_ready) {
+				if(line_dropped != 0xffff) {
+					line_dropped++;
+				}
+			} else {
+				/* hand the line over and continue in the other buffer */
+				line_buffer[line_fill][line_len] = '\0';
+				line_fill ^= 1;
+				line_ready = 1;
+#if UART_FLOW_CONTROL
+				/* the next line would be dropped, hold the host until 
+				 * uart_line_release */
+				UART_RTS_STOP();
+#endif
+			}
+			line_len = 0;
+			line_discard = 0;
+			break;
+		case UART_LINE_BACKSPACE:
+		case UART_LINE_DELETE:
+			if(line_len) {
+				line_len--;
+			}
+			break;
+		default:
+			if(line_discard) {
+				break;
+			}
+			if(line_len < (UART_LINE_SIZE - 1)) {
+				line_buffer[line_fill][line_len++] = ui8_data;
+			} else {
+				/* the rest of the line is thrown away */
+				line_discard = 1;
+			}
+			break;
+	}
+}
+
+#endif
+
+#if UART_FLOW_CONTROL
+
+/* CTS changed, continue sending once the host is ready again */
+ISR (UART_CTS_vect) {
+	/* the data register empty interrupt turns itself off again if 
+	 * there is nothing to send */
+	if(UART_CTS_READY) {
+		UCSR0B |= (1<<UDRIE0);
+	}
+}
+
+#endif
+
+#endif
+
 
 /*********************************************************************
  * EOF
@@ -10,6 +10,10 @@
  * Changelog:
  * [Date][Author]:[Change]
  * [15.09.2019][nmt]: initial commit
+ * [17.10.2026][nmt]: added ring buffer settings for the interrupt mode
+ * [17.10.2026][nmt]: compile time baudrate solver with U2X0
+ * [17.10.2026][nmt]: line mode settings
+ * [17.10.2026][nmt]: RTS/CTS flow control settings
  *********************************************************************/
 
 #ifndef UART_CFG_H
@@ -21,9 +25,141 @@
 	#define F_CPU 16000000UL
 #endif
 
- /* baudrate we want to use */
-#define BAUDRATE 9600       
-/* calculate prescaler value */
-#define PRESCALE_VALUE (((F_CPU / (BAUDRATE * 16UL))) - 1)    
+ /* baudrate we want to use, can also be set in the Makefile */
+#ifndef BAUDRATE
+	#define BAUDRATE 9600
+#endif
+/* maximum error of the baudrate in percent, the build fails if the 
+ * baudrate can not be reached with this tolerance. At 16 MHz 250000,
+ * 500000 and 1000000 baud are exact, 115200 has an error of 2.1 % in
+ * double speed mode and needs a tolerance of 3 */
+#ifndef UART_BAUD_TOL
+	#define UART_BAUD_TOL 2
+#endif
+
+/* NOTE: the baudrate is calculated as follows, see table 19-1 of the
+ * ATmega328p datasheet:
+ * normal mode (U2X0 = 0):	BAUD = F_CPU / (16 * (UBRR0 + 1))
+ * double speed (U2X0 = 1):	BAUD = F_CPU / (8 * (UBRR0 + 1))
+ * Double speed halves the divider, so it reaches higher baudrates 
+ * and a finer grid, but samples each bit fewer times. The solver 
+ * below rounds UBRR0 for both modes and keeps the one with the 
+ * smaller error, normal mode wins a tie. Everything is evaluated by
+ * the preprocessor, nothing of it ends up in the program. */
+
+/* rounded divider for both modes, 0 if the mode is too slow */
+#define UART_UBRR_DIV_16 ((F_CPU + 8UL * BAUDRATE) / (16UL * BAUDRATE))
+#define UART_UBRR_DIV_8 ((F_CPU + 4UL * BAUDRATE) / (8UL * BAUDRATE))
+
+/* error of a divider in 1/1000, the clock ticks per bit of the 
+ * divider are compared to the ticks per bit we need */
+#define UART_ABS_DIFF(a, b) (((a) > (b)) ? ((a) - (b)) : ((b) - (a)))
+#define UART_BAUD_ERROR(ticks) (UART_ABS_DIFF(F_CPU, (ticks) * BAUDRATE) * 1000UL / ((ticks) * BAUDRATE))
+
+#if (UART_UBRR_DIV_16 >= 1) && (UART_UBRR_DIV_16 <= 4096)
+	#define UART_ERROR_16 UART_BAUD_ERROR(16UL * UART_UBRR_DIV_16)
+#else
+	/* divider out of range, never pick this mode */
+	#define UART_ERROR_16 1000UL
+#endif
+#if (UART_UBRR_DIV_8 >= 1) && (UART_UBRR_DIV_8 <= 4096)
+	#define UART_ERROR_8 UART_BAUD_ERROR(8UL * UART_UBRR_DIV_8)
+#else
+	#define UART_ERROR_8 1000UL
+#endif
+
+/* pick the mode, UART_USE_2X is 1 for double speed */
+#if UART_ERROR_16 <= UART_ERROR_8
+	#define UART_USE_2X 0
+	#define UART_BAUD_ERROR_PERMILLE UART_ERROR_16
+	#define PRESCALE_VALUE (UART_UBRR_DIV_16 - 1)
+#else
+	#define UART_USE_2X 1
+	#define UART_BAUD_ERROR_PERMILLE UART_ERROR_8
+	#define PRESCALE_VALUE (UART_UBRR_DIV_8 - 1)
+#endif
+
+#if UART_BAUD_ERROR_PERMILLE > (UART_BAUD_TOL * 10UL)
+	#error "UART_CFG: BAUDRATE can not be reached within UART_BAUD_TOL at this F_CPU"
+#endif
+
+/* set to 1 to send and receive using the USART_UDRE and USART_RX
+ * interrupts and the ring buffers below, set to 0 to use the old
+ * polling driver */
+#ifndef UART_ISR_MODE
+	#define UART_ISR_MODE 1
+#endif
+
+/* sizes of the ring buffers in bytes, these must be a power of two
+ * and at most 128, because the indices are masked and stored in 
+ * 8 bits */
+#define UART_TX_BUFFER_SIZE 64
+#define UART_RX_BUFFER_SIZE 32
+
+#if (UART_TX_BUFFER_SIZE & (UART_TX_BUFFER_SIZE - 1)) || (UART_TX_BUFFER_SIZE > 128)
+	#error "UART_CFG: UART_TX_BUFFER_SIZE must be a power of two <= 128"
+#endif
+#if (UART_RX_BUFFER_SIZE & (UART_RX_BUFFER_SIZE - 1)) || (UART_RX_BUFFER_SIZE > 128)
+	#error "UART_CFG: UART_RX_BUFFER_SIZE must be a power of two <= 128"
+#endif
+
+/* set to 1 to receive whole lines instead of single bytes, the 
+ * receive interrupt then assembles the lines itself, see 
+ * uart_line_get. Can also be set in the Makefile. */
+#ifndef UART_LINE_MODE
+	#define UART_LINE_MODE 0
+#endif
+
+/* maximum length of a line including the terminating zero, longer 
+ * lines are dropped */
+#define UART_LINE_SIZE 48
+
+#if UART_LINE_MODE && !UART_ISR_MODE
+	#error "UART_CFG: UART_LINE_MODE needs UART_ISR_MODE"
+#endif
+#if (UART_LINE_SIZE < 2) || (UART_LINE_SIZE > 255)
+	#error "UART_CFG: UART_LINE_SIZE must be in [2 - 255]"
+#endif
+
+/* set to 1 for hardware flow control with RTS and CTS on GPIO pins,
+ * needed at high baudrates where the host or the main loop can not 
+ * always keep up. Can also be set in the Makefile. Both lines are 
+ * active low, connect RTS to CTS of the host (e.g. an FTDI adapter) 
+ * and CTS to its RTS. 
+ * CTS: input with pull-up, we only send while it is low. A pin change
+ *			interrupt continues sending when it goes low again. 
+ * RTS: output, set high when the receive ring buffer only has 
+ *			UART_RTS_MARGIN free bytes left, or in line mode while the main 
+ *			loop holds a line, set low again once there is room. */
+#ifndef UART_FLOW_CONTROL
+	#define UART_FLOW_CONTROL 0
+#endif
+
+/* RTS on pin D7 */
+#define UART_RTS_DDR DDRD
+#define UART_RTS_PORT PORTD
+#define UART_RTS_BIT PD7
+
+/* CTS on pin D4, PCINT20 */
+#define UART_CTS_DDR DDRD
+#define UART_CTS_PORT PORTD
+#define UART_CTS_PIN PIND
+#define UART_CTS_BIT PD4
+#define UART_CTS_PCMSK PCMSK2
+#define UART_CTS_PCINT PCINT20
+#define UART_CTS_PCIE PCIE2
+#define UART_CTS_vect PCINT2_vect
+
+/* free bytes in the receive ring buffer when RTS stops the host, it 
+ * has to cover what the host sends before it reacts, USB adapters 
+ * may send a few bytes more. RTS is released at half the buffer. */
+#define UART_RTS_MARGIN 8
+
+#if UART_FLOW_CONTROL && !UART_ISR_MODE
+	#error "UART_CFG: UART_FLOW_CONTROL needs UART_ISR_MODE"
+#endif
+#if UART_RTS_MARGIN >= (UART_RX_BUFFER_SIZE / 2)
+	#error "UART_CFG: UART_RTS_MARGIN must be less than half of UART_RX_BUFFER_SIZE"
+#endif
 
 #endif
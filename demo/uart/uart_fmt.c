@@ -0,0 +1,153 @@
+/*********************************************************************
+ * UART Number Formatting - C File
+ * Short Name: uart_fmt
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: prints integers, hex and fixed-point values over the
+ *							UART without printf
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <avr/pgmspace.h>
+
+#include "uart.h"
+#include "uart_fmt.h"
+
+/*********************************************************************
+ * VARIABLES
+ *********************************************************************/
+/* powers of ten for the digit search, largest first */
+static const uint32_t pow10_32[] PROGMEM = {
+	1000000000UL, 100000000UL, 10000000UL, 1000000UL, 100000UL, 10000UL
+};
+static const uint16_t pow10_16[] PROGMEM = {
+	10000, 1000, 100, 10
+};
+
+static const char hex_digits[] PROGMEM = "0123456789abcdef";
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+/* prints the digits of a 16 bit value beginning with the power of ten
+ * at index first, started tells if a digit was printed already, so 
+ * zeros are no longer leading */
+static void uart_print_digits16(uint16_t value, uint8_t first, uint8_t started) {
+
+	uint8_t i = first;
+	uint16_t pow10 = 0;
+	uint8_t digit = 0;
+
+	for(; i < sizeof(pow10_16) / sizeof(pow10_16[0]); i++) {
+		pow10 = pgm_read_word(&pow10_16[i]);
+		/* at most 9 subtractions find the digit */
+		digit = '0';
+		while(value >= pow10) {
+			value -= pow10;
+			digit++;
+		}
+		if(started || (digit != '0')) {
+			uart_send(digit);
+			started = 1;
+		}
+	}
+	/* the last digit is what is left */
+	uart_send('0' + (uint8_t)value);
+}
+
+void uart_print_u16(uint16_t value) {
+	uart_print_digits16(value, 0, 0);
+}
+
+void uart_print_i16(int16_t value) {
+	if(value < 0) {
+		uart_send('-');
+		/* the cast handles -32768 */
+		uart_print_digits16((uint16_t)0 - (uint16_t)value, 0, 0);
+	} else {
+		uart_print_digits16((uint16_t)value, 0, 0);
+	}
+}
+
+void uart_print_u32(uint32_t value) {
+
+	uint8_t i = 0;
+	uint32_t pow10 = 0;
+	uint8_t digit = 0;
+	uint8_t started = 0;
+
+	/* the upper digits need 32 bit, below 10000 16 bit are enough */
+	for(i = 0; i < sizeof(pow10_32) / sizeof(pow10_32[0]); i++) {
+		pow10 = pgm_read_dword(&pow10_32[i]);
+		digit = '0';
+		while(value >= pow10) {
+			value -= pow10;
+			digit++;
+		}
+		if(started || (digit != '0')) {
+			uart_send(digit);
+			started = 1;
+		}
+	}
+	uart_print_digits16((uint16_t)value, 1, started);
+}
+
+void uart_print_i32(int32_t value) {
+	if(value < 0) {
+		uart_send('-');
+		uart_print_u32((uint32_t)0 - (uint32_t)value);
+	} else {
+		uart_print_u32((uint32_t)value);
+	}
+}
+
+void uart_print_hex8(uint8_t value) {
+	uart_send(pgm_read_byte(&hex_digits[value >> 4]));
+	uart_send(pgm_read_byte(&hex_digits[value & 0x0f]));
+}
+
+void uart_print_hex16(uint16_t value) {
+	uart_print_hex8((uint8_t)(value >> 8));
+	uart_print_hex8((uint8_t)value);
+}
+
+void uart_print_fixed(int16_t value, uint8_t frac_bits, uint8_t decimals) {
+
+	uint16_t magnitude = (uint16_t)value;
+	uint16_t mask = (1U << frac_bits) - 1;
+	uint32_t fraction = 0;
+
+	if(value < 0) {
+		uart_send('-');
+		magnitude = (uint16_t)0 - magnitude;
+	}
+
+	/* integer part */
+	uart_print_digits16(magnitude >> frac_bits, 0, 0);
+	if(!decimals) {
+		return;
+	}
+	uart_send('.');
+
+	/* every multiplication by 10 moves the next decimal into the 
+	 * integer bits, x * 10 = x * 8 + x * 2 */
+	fraction = magnitude & mask;
+	while(decimals) {
+		fraction = (fraction << 3) + (fraction << 1);
+		uart_send('0' + (uint8_t)(fraction >> frac_bits));
+		fraction &= mask;
+		decimals--;
+	}
+}
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
@@ -0,0 +1,96 @@
+/*********************************************************************
+ * UART Number Formatting - Header File
+ * Short Name: uart_fmt
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: prints integers, hex and fixed-point values over the
+ *							UART without printf
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * NOTES:	the AVR has no divide instruction, a division by 10 is a 
+ *				library call of a few hundred cycles. These functions 
+ *				find the digits by subtracting powers of ten from a table
+ *				instead, the fraction of fixed-point values is found by 
+ *				multiplying with 10 (shift and add). Every character goes 
+ *				straight into the transmit ring buffer with uart_send, no
+ *				string is built in between. See demo/benchmark for a cycle
+ *				comparison with utoa and snprintf.
+ *********************************************************************/
+
+#ifndef UART_FMT_H
+#define UART_FMT_H
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <stdint.h>
+
+/*********************************************************************
+ * FUNCTION PROTOTYPES
+ *********************************************************************/
+
+/**
+ * @brief prints an unsigned 16 bit value in decimal
+ * @param value the value
+ * @return void
+ */
+void uart_print_u16(uint16_t value);
+
+/**
+ * @brief prints a signed 16 bit value in decimal, with '-' if negative
+ * @param value the value
+ * @return void
+ */
+void uart_print_i16(int16_t value);
+
+/**
+ * @brief prints an unsigned 32 bit value in decimal
+ * @param value the value
+ * @return void
+ */
+void uart_print_u32(uint32_t value);
+
+/**
+ * @brief prints a signed 32 bit value in decimal, with '-' if negative
+ * @param value the value
+ * @return void
+ */
+void uart_print_i32(int32_t value);
+
+/**
+ * @brief prints a byte as two hex digits, without prefix
+ * @param value the value
+ * @return void
+ */
+void uart_print_hex8(uint8_t value);
+
+/**
+ * @brief prints a 16 bit value as four hex digits, without prefix
+ * @param value the value
+ * @return void
+ */
+void uart_print_hex16(uint16_t value);
+
+/**
+ * @brief prints a signed fixed-point value (Q format)
+ * NOTE: e.g. the accelerometer of the MPU6050 at +-2 g is Q1.14, so
+ * uart_print_fixed(acc, 14, 3) prints g with three decimals. The 
+ * fraction is truncated, not rounded.
+ * @param value the raw value
+ * @param frac_bits number of fractional bits range: [0 - 15]
+ * @param decimals number of decimals to print range: [0 - 5]
+ * @return void
+ */
+void uart_print_fixed(int16_t value, uint8_t frac_bits, uint8_t decimals);
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
+#endif
@@ -0,0 +1,281 @@
+/*********************************************************************
+ * Framed Streaming Protocol - Host Decoder
+ * Short Name: frame_decode
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: reads SLIP encoded frames from a serial port or stdin,
+ *							checks the CRC and the sequence numbers and prints 
+ *							one line per frame
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * Usage:
+ *					./frame_decode /dev/ttyACM0 115200
+ *					./frame_decode - < capture.bin
+ *
+ *					Every valid frame is printed as 
+ *					seq,type,timestamp,payload length,payload in hex
+ *					A summary with the number of frames, CRC errors and 
+ *					dropped frames goes to stderr on exit (EOF or Ctrl-C).
+ *
+ *					The frame format is described in demo/twi/frame.h.
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* SLIP special characters, same as in frame.h */
+#define FRAME_END			0xc0
+#define FRAME_ESC			0xdb
+#define FRAME_ESC_END	0xdc
+#define FRAME_ESC_ESC	0xdd
+
+/* type, seq, timestamp and CRC */
+#define FRAME_OVERHEAD 6
+/* frames are limited by the payload length of 255 on the AVR side,
+ * FRAME_TYPE_ACC frames may be longer, so be generous */
+#define FRAME_MAX 2048
+
+/*********************************************************************
+ * VARIABLES
+ *********************************************************************/
+static volatile sig_atomic_t stop = 0;
+
+/* statistics */
+static unsigned long frames = 0;
+static unsigned long crc_errors = 0;
+static unsigned long short_frames = 0;
+static unsigned long overruns = 0;
+static unsigned long dropped = 0;
+static unsigned long long bytes = 0;
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+static void on_signal(int sig) {
+	(void)sig;
+	stop = 1;
+}
+
+/* CRC-16/XMODEM, same as _crc_xmodem_update of avr-libc */
+static uint16_t crc_xmodem_update(uint16_t crc, uint8_t data) {
+
+	int i;
+
+	crc ^= (uint16_t)data << 8;
+	for(i = 0; i < 8; i++) {
+		if(crc & 0x8000) {
+			crc = (crc << 1) ^ 0x1021;
+		} else {
+			crc <<= 1;
+		}
+	}
+	return crc;
+}
+
+static speed_t baud_to_speed(long baud) {
+	switch(baud) {
+		case 9600:		return B9600;
+		case 19200:		return B19200;
+		case 38400:		return B38400;
+		case 57600:		return B57600;
+		case 115200:	return B115200;
+		case 230400:	return B230400;
+		case 460800:	return B460800;
+		case 500000:	return B500000;
+		case 921600:	return B921600;
+		case 1000000:	return B1000000;
+		default:			return 0;
+	}
+}
+
+/* opens the serial port in raw mode, 8N1 */
+static int open_port(const char *path, long baud) {
+
+	struct termios tio;
+	speed_t speed = baud_to_speed(baud);
+	int fd;
+
+	if(speed == 0) {
+		fprintf(stderr, "unsupported baud rate %ld\n", baud);
+		return -1;
+	}
+
+	fd = open(path, O_RDONLY | O_NOCTTY);
+	if(fd < 0) {
+		perror(path);
+		return -1;
+	}
+	if(tcgetattr(fd, &tio)) {
+		perror("tcgetattr");
+		close(fd);
+		return -1;
+	}
+	cfmakeraw(&tio);
+	cfsetispeed(&tio, speed);
+	cfsetospeed(&tio, speed);
+	tio.c_cflag |= CLOCAL | CREAD;
+	tio.c_cc[VMIN] = 1;
+	tio.c_cc[VTIME] = 0;
+	if(tcsetattr(fd, TCSANOW, &tio)) {
+		perror("tcsetattr");
+		close(fd);
+		return -1;
+	}
+	tcflush(fd, TCIFLUSH);
+
+	return fd;
+}
+
+/* checks and prints one decoded frame */
+static void handle_frame(const uint8_t *frame, size_t len) {
+
+	static int have_seq = 0;
+	static uint8_t next_seq = 0;
+	uint16_t crc = 0;
+	size_t i;
+
+	if(len < FRAME_OVERHEAD) {
+		short_frames++;
+		return;
+	}
+	for(i = 0; i < len - 2; i++) {
+		crc = crc_xmodem_update(crc, frame[i]);
+	}
+	if(crc != (uint16_t)(frame[len - 2] | (frame[len - 1] << 8))) {
+		crc_errors++;
+		return;
+	}
+
+	/* every gap in the sequence numbers is a lost frame */
+	if(have_seq) {
+		dropped += (uint8_t)(frame[1] - next_seq);
+	}
+	have_seq = 1;
+	next_seq = frame[1] + 1;
+	frames++;
+
+	printf("%u,%u,%u,%zu,", frame[1], frame[0], frame[2] | (frame[3] << 8), 
+			len - FRAME_OVERHEAD);
+	for(i = 4; i < len - 2; i++) {
+		printf("%02x", frame[i]);
+	}
+	putchar('\n');
+}
+
+/*********************************************************************
+ * MAIN FUNCTION
+ *********************************************************************/
+int main(int argc, char **argv) {
+
+	uint8_t in[256];
+	uint8_t frame[FRAME_MAX];
+	size_t len = 0;
+	int escaped = 0;
+	int overrun = 0;
+	int fd = STDIN_FILENO;
+	struct timespec t_start, t_end;
+	double seconds;
+	ssize_t n, i;
+
+	if(argc < 2) {
+		fprintf(stderr, "usage: %s <serial port> [baud] | -\n", argv[0]);
+		return 1;
+	}
+	if(strcmp(argv[1], "-") != 0) {
+		fd = open_port(argv[1], (argc > 2) ? strtol(argv[2], NULL, 10) : 9600);
+		if(fd < 0) {
+			return 1;
+		}
+	}
+
+	signal(SIGINT, on_signal);
+	signal(SIGTERM, on_signal);
+	clock_gettime(CLOCK_MONOTONIC, &t_start);
+
+	while(!stop) {
+
+		n = read(fd, in, sizeof(in));
+		if(n < 0) {
+			if(errno == EINTR) {
+				continue;
+			}
+			perror("read");
+			break;
+		}
+		if(n == 0) {
+			break;
+		}
+		bytes += n;
+
+		/* SLIP decoding */
+		for(i = 0; i < n; i++) {
+			uint8_t c = in[i];
+
+			if(c == FRAME_END) {
+				if(len && !overrun) {
+					handle_frame(frame, len);
+				}
+				len = 0;
+				escaped = 0;
+				overrun = 0;
+				continue;
+			}
+			if(c == FRAME_ESC) {
+				escaped = 1;
+				continue;
+			}
+			if(escaped) {
+				c = (c == FRAME_ESC_END) ? FRAME_END : 
+						(c == FRAME_ESC_ESC) ? FRAME_ESC : c;
+				escaped = 0;
+			}
+			if(len == sizeof(frame)) {
+				if(!overrun) {
+					overruns++;
+				}
+				overrun = 1;
+				continue;
+			}
+			frame[len++] = c;
+		}
+		fflush(stdout);
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &t_end);
+	seconds = (t_end.tv_sec - t_start.tv_sec) + (t_end.tv_nsec - t_start.tv_nsec) / 1e9;
+
+	fprintf(stderr, "frames: %lu, dropped: %lu, crc errors: %lu, short: %lu, "
+			"too long: %lu, bytes: %llu, %.1f bytes/s\n", frames, dropped, crc_errors,
+			short_frames, overruns, bytes, (seconds > 0) ? bytes / seconds : 0.0);
+
+	if(fd != STDIN_FILENO) {
+		close(fd);
+	}
+
+	return 0;
+}
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
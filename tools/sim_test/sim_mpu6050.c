@@ -0,0 +1,139 @@
+/*********************************************************************
+ * Simulation Test - MPU6050 Model - C File
+ * Short Name: sim_mpu6050
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: I2C slave for simavr with the registers of the MPU6050
+ *							that the TWI demo uses
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <string.h>
+
+#include "sim_io.h"
+#include "avr_twi.h"
+
+#include "sim_mpu6050.h"
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* registers with a value after reset, see the register map of the
+ * MPU6050 */
+#define MPU6050_SAMPLE_REGISTER 0x3b
+#define MPU6050_INT_STATUS_REGISTER 0x3a
+#define MPU6050_PWR_MGMT_1_REGISTER 0x6b
+#define MPU6050_FIFO_R_W_REGISTER 0x74
+#define MPU6050_WHO_AM_I_REGISTER 0x75
+
+/*********************************************************************
+ * VARIABLES
+ *********************************************************************/
+static const char *irq_names[2] = {
+	[TWI_IRQ_INPUT] = "8>mpu6050.out",
+	[TWI_IRQ_OUTPUT] = "32<mpu6050.in",
+};
+
+/* accelerometer x/y/z, temperature, gyroscope x/y/z, big endian */
+static const uint8_t sample[14] = {
+	0x00, 0x00, 0x00, 0x00, 0x40, 0x00,
+	0xf0, 0xb0,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+};
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ *********************************************************************/
+/* answers the AVR on the TWI_IRQ_INPUT of its TWI */
+static void sim_mpu6050_reply(struct sim_mpu6050 *mpu, uint8_t msg, uint8_t data) {
+	avr_raise_irq(mpu->irq + TWI_IRQ_INPUT, avr_twi_irq_msg(msg, mpu->selected, data));
+}
+
+/* every condition the AVR puts on the bus */
+static void sim_mpu6050_bus(struct avr_irq_t *irq, uint32_t value, void *param) {
+
+	struct sim_mpu6050 *mpu = (struct sim_mpu6050 *)param;
+	avr_twi_msg_irq_t v;
+
+	v.u.v = value;
+
+	if(v.u.twi.msg & TWI_COND_STOP) {
+		mpu->selected = 0;
+	}
+
+	if(v.u.twi.msg & TWI_COND_START) {
+		mpu->selected = 0;
+		/* the address byte includes the R/W bit */
+		if((v.u.twi.addr >> 1) == SIM_MPU6050_ADDR) {
+			mpu->selected = v.u.twi.addr;
+			/* only a write sets the pointer, a repeated start for
+			 * reading keeps it */
+			mpu->pointer_next = !(v.u.twi.addr & 1);
+			mpu->transactions++;
+			sim_mpu6050_reply(mpu, TWI_COND_ACK, 1);
+		}
+	}
+
+	if(!mpu->selected) {
+		return;
+	}
+
+	if(v.u.twi.msg & TWI_COND_WRITE) {
+		sim_mpu6050_reply(mpu, TWI_COND_ACK, 1);
+		mpu->bytes++;
+		if(mpu->pointer_next) {
+			mpu->pointer = v.u.twi.data & (SIM_MPU6050_REGISTERS - 1);
+			mpu->pointer_next = 0;
+		} else {
+			/* WHO_AM_I is read only */
+			if(mpu->pointer != MPU6050_WHO_AM_I_REGISTER) {
+				mpu->regs[mpu->pointer] = v.u.twi.data;
+			}
+			mpu->writes[mpu->pointer]++;
+			mpu->pointer = (mpu->pointer + 1) & (SIM_MPU6050_REGISTERS - 1);
+		}
+	}
+
+	if(v.u.twi.msg & TWI_COND_READ) {
+		sim_mpu6050_reply(mpu, TWI_COND_READ, mpu->regs[mpu->pointer]);
+		mpu->bytes++;
+		/* the FIFO register is read again and again */
+		if(mpu->pointer != MPU6050_FIFO_R_W_REGISTER) {
+			mpu->pointer = (mpu->pointer + 1) & (SIM_MPU6050_REGISTERS - 1);
+		}
+	}
+}
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+void sim_mpu6050_attach(struct sim_mpu6050 *mpu, avr_t *avr) {
+
+	avr_irq_t *twi_input = avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT);
+	avr_irq_t *twi_output = avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT);
+
+	memset(mpu, 0, sizeof(*mpu));
+	mpu->regs[MPU6050_PWR_MGMT_1_REGISTER] = 0x40;
+	mpu->regs[MPU6050_WHO_AM_I_REGISTER] = SIM_MPU6050_ADDR;
+	/* DATA_RDY_INT */
+	mpu->regs[MPU6050_INT_STATUS_REGISTER] = 0x01;
+	memcpy(&mpu->regs[MPU6050_SAMPLE_REGISTER], sample, sizeof(sample));
+
+	mpu->irq = avr_alloc_irq(&avr->irq_pool, 0, 2, irq_names);
+	avr_irq_register_notify(mpu->irq + TWI_IRQ_OUTPUT, sim_mpu6050_bus, mpu);
+
+	avr_connect_irq(mpu->irq + TWI_IRQ_INPUT, twi_input);
+	avr_connect_irq(twi_output, mpu->irq + TWI_IRQ_OUTPUT);
+}
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
@@ -0,0 +1,93 @@
+/*********************************************************************
+ * Simulation Test - MPU6050 Model - Header File
+ * Short Name: sim_mpu6050
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: I2C slave for simavr with the registers of the MPU6050
+ *							that the TWI demo uses
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * NOTES:	The model answers on address 0x68 like the real sensor with
+ *				AD0 low. The first byte written after the address is the
+ *				register pointer, every further byte is written to the
+ *				register and the pointer moves on, reads start at the
+ *				pointer and move on as well. A repeated start keeps the
+ *				pointer, so the burst read of demo/twi/twi.c works.
+ *
+ *				Registers after a reset: PWR_MGMT_1 is 0x40 (sleep),
+ *				WHO_AM_I is 0x68, INT_STATUS has the data ready bit set.
+ *				The sample registers 0x3b - 0x48 hold a fixed sample, the
+ *				sensor lying flat at 25 degree C:
+ *
+ *				ACCEL_X/Y 0, ACCEL_Z 16384 (1 g), TEMP 0xf0b0, GYRO 0
+ *
+ *				Fixed values keep the UART output of the demo the same on
+ *				every run, so it can be compared with a golden file. The
+ *				FIFO is not modelled, FIFO_COUNT stays 0.
+ *
+ *				Every write of a register is counted, a test can check
+ *				that e.g. the wake up reached the sensor.
+ *********************************************************************/
+
+#ifndef SIM_MPU6050_H
+#define SIM_MPU6050_H
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <stdint.h>
+
+#include "sim_avr.h"
+#include "sim_irq.h"
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* 7-bit address, AD0 low */
+#define SIM_MPU6050_ADDR 0x68
+
+#define SIM_MPU6050_REGISTERS 128
+
+/*********************************************************************
+ * TYPES
+ *********************************************************************/
+struct sim_mpu6050 {
+	/* TWI_IRQ_OUTPUT from the AVR and TWI_IRQ_INPUT to it */
+	avr_irq_t *irq;
+	uint8_t regs[SIM_MPU6050_REGISTERS];
+	/* writes of each register */
+	uint32_t writes[SIM_MPU6050_REGISTERS];
+	/* addressed since the last start condition */
+	uint8_t selected;
+	/* the next write sets the register pointer */
+	uint8_t pointer_next;
+	uint8_t pointer;
+	/* transactions and bytes, for the report */
+	uint32_t transactions;
+	uint32_t bytes;
+};
+
+/*********************************************************************
+ * FUNCTION PROTOTYPES
+ *********************************************************************/
+
+/**
+ * @brief resets the registers and connects the model to the TWI of
+ * the AVR
+ * @param mpu the model
+ * @param avr the simulated AVR
+ * @return void
+ */
+void sim_mpu6050_attach(struct sim_mpu6050 *mpu, avr_t *avr);
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
+#endif
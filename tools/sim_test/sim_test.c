@@ -0,0 +1,708 @@
+/*********************************************************************
+ * Simulation Test - Host Program
+ * Short Name: sim_test
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: runs a demo in simavr without hardware and checks its
+ *							UART output and pin timing
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * Usage:
+ *					./sim_test [options] firmware.elf
+ *
+ *					-t MS							stop after MS ms of simulated time,
+ *														default 1000
+ *					-m								connects the MPU6050 model to the TWI
+ *					-i FILE						UART input, one line per command:
+ *														MS TEXT, TEXT and a \n are sent at MS
+ *					-g FILE						the UART output must equal FILE
+ *					-G FILE						the UART output must start with FILE
+ *					-d MS							the expected output must be complete
+ *														at MS, a throughput check
+ *					-o FILE						writes the UART output to FILE
+ *					-b FILE:PERCENT		compares the benchmark CSV in the UART
+ *														output with FILE, an average more than
+ *														PERCENT higher fails
+ *					-v FILE						VCD file for the pins, default
+ *														sim_test.vcd
+ *					-p PIN:MIN:MAX:N	at least N periods (rising to rising
+ *														edge), all in [MIN - MAX] us
+ *					-w PIN:MIN:MAX:N	at least N high pulses, all in
+ *														[MIN - MAX] us
+ *					-e PIN:N					at least N edges
+ *					-l PIN:LEVEL			level of the pin at the end
+ *					-s PIN:MS:LEVEL		drives an input pin from MS on
+ *					-c PIN:PIN				connects an output to an input, like a
+ *														wire on the board
+ *
+ *					PIN is e.g. PB3. Expected output files ending in .hex
+ *					hold hex bytes separated by whitespace, # starts a
+ *					comment, all other files are compared byte by byte.
+ *
+ *					The simulation ends at the time limit or when the
+ *					firmware sleeps with interrupts disabled. The pins of
+ *					the checks are written to the VCD file while it runs,
+ *					the checks read it back afterwards. Exit code 0 if all
+ *					checks passed, 1 if one failed, 2 on errors.
+ *
+ *					The demos are built and checked by "make test", see the
+ *					Makefile.
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_io.h"
+#include "sim_irq.h"
+#include "sim_time.h"
+#include "sim_vcd_file.h"
+#include "avr_ioport.h"
+#include "avr_uart.h"
+
+#include "sim_mpu6050.h"
+#include "sim_vcd.h"
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+#define MAX_CHECKS 32
+#define MAX_EVENTS 256
+#define MAX_WIRES 8
+#define MAX_OUTPUT 65536
+#define MAX_GOLDEN 65536
+#define MAX_LINE 256
+#define PIN_NAME_SIZE 8
+
+/* clock if the firmware has no .mmcu section */
+#define DEFAULT_FREQUENCY 16000000UL
+
+/* simavr queues up to 64 received bytes */
+#define UART_INPUT_MAX 63
+
+/*********************************************************************
+ * TYPES
+ *********************************************************************/
+enum CHECK_TYPES {
+	CHECK_PERIOD,
+	CHECK_WIDTH,
+	CHECK_EDGES,
+	CHECK_LEVEL
+};
+
+struct check {
+	uint8_t type;
+	char pin[PIN_NAME_SIZE];
+	uint32_t min;
+	uint32_t max;
+	uint32_t count;
+};
+
+/* UART input or a pin driven from a point in time on */
+struct event {
+	uint64_t cycle;
+	/* NULL for a pin */
+	char *text;
+	char pin[PIN_NAME_SIZE];
+	uint8_t level;
+};
+
+/*********************************************************************
+ * VARIABLES
+ *********************************************************************/
+static avr_t *avr = 0;
+
+static struct check checks[MAX_CHECKS];
+static int check_count = 0;
+
+static struct event events[MAX_EVENTS];
+static int event_count = 0;
+
+/* output and input pin of each wire */
+static char wires[MAX_WIRES][2][PIN_NAME_SIZE];
+static int wire_count = 0;
+
+/* UART output and the cycle of each byte */
+static uint8_t output[MAX_OUTPUT];
+static uint64_t output_cycle[MAX_OUTPUT];
+static uint32_t output_len = 0;
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ *********************************************************************/
+static void usage(const char *name) {
+	fprintf(stderr, "usage: %s [-t ms] [-m] [-i input] [-g|-G golden] [-d ms] [-o output]\n"
+									"       [-b baseline:percent] [-v vcd] [-p pin:min:max:n] [-w pin:min:max:n]\n"
+									"       [-e pin:n] [-l pin:level] [-s pin:ms:level] [-c pin:pin] firmware.elf\n", name);
+}
+
+/* "PB3" to port 'B' and bit 3 */
+static int pin_parse(const char *pin, char *port, int *bit) {
+
+	if((strlen(pin) != 3) || (pin[0] != 'P') || (pin[1] < 'B') || (pin[1] > 'D') ||
+		 (pin[2] < '0') || (pin[2] > '7')) {
+		fprintf(stderr, "unknown pin %s\n", pin);
+		return 1;
+	}
+	*port = pin[1];
+	*bit = pin[2] - '0';
+	return 0;
+}
+
+static avr_irq_t *pin_irq(const char *pin) {
+
+	char port = 0;
+	int bit = 0;
+
+	if(pin_parse(pin, &port, &bit)) {
+		return 0;
+	}
+	return avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ(port), bit);
+}
+
+/* "PB3:990:1010:20" and the like, the pin is always first */
+static int check_parse(uint8_t type, const char *arg) {
+
+	struct check *check = &checks[check_count];
+	char port = 0;
+	int bit = 0;
+	int fields = 0;
+
+	if(check_count >= MAX_CHECKS) {
+		fprintf(stderr, "too many checks\n");
+		return 1;
+	}
+	memset(check, 0, sizeof(*check));
+	check->type = type;
+
+	switch(type) {
+		case CHECK_PERIOD:
+		case CHECK_WIDTH:
+			fields = sscanf(arg, "%3[^:]:%u:%u:%u", check->pin, &check->min, &check->max, &check->count);
+			fields = (fields == 4);
+			break;
+		case CHECK_EDGES:
+			fields = (sscanf(arg, "%3[^:]:%u", check->pin, &check->count) == 2);
+			break;
+		case CHECK_LEVEL:
+			fields = (sscanf(arg, "%3[^:]:%u", check->pin, &check->count) == 2);
+			break;
+	}
+	if(!fields || pin_parse(check->pin, &port, &bit)) {
+		fprintf(stderr, "bad check %s\n", arg);
+		return 1;
+	}
+	check_count++;
+
+	return 0;
+}
+
+static int event_add(uint32_t ms, char *text, const char *pin, uint8_t level) {
+
+	struct event *event = &events[event_count];
+
+	if(event_count >= MAX_EVENTS) {
+		fprintf(stderr, "too many input events\n");
+		return 1;
+	}
+	/* converted to cycles once the frequency is known */
+	event->cycle = ms;
+	event->text = text;
+	event->level = level;
+	if(pin) {
+		strncpy(event->pin, pin, PIN_NAME_SIZE - 1);
+	}
+	event_count++;
+
+	return 0;
+}
+
+/* "PD2:10:0" */
+static int stimulus_parse(const char *arg) {
+
+	char pin[PIN_NAME_SIZE] = "";
+	char port = 0;
+	int bit = 0;
+	uint32_t ms = 0;
+	unsigned level = 0;
+
+	if((sscanf(arg, "%3[^:]:%u:%u", pin, &ms, &level) != 3) || pin_parse(pin, &port, &bit)) {
+		fprintf(stderr, "bad stimulus %s\n", arg);
+		return 1;
+	}
+	return event_add(ms, 0, pin, level ? 1 : 0);
+}
+
+/* "PB3:PB0" */
+static int wire_parse(const char *arg) {
+
+	char port = 0;
+	int bit = 0;
+
+	if((wire_count >= MAX_WIRES) ||
+		 (sscanf(arg, "%3[^:]:%3s", wires[wire_count][0], wires[wire_count][1]) != 2) ||
+		 pin_parse(wires[wire_count][0], &port, &bit) ||
+		 pin_parse(wires[wire_count][1], &port, &bit)) {
+		fprintf(stderr, "bad wire %s\n", arg);
+		return 1;
+	}
+	wire_count++;
+
+	return 0;
+}
+
+/* lines "MS TEXT", empty lines and lines starting with # are
+ * skipped */
+static int input_read(const char *path) {
+
+	FILE *file = fopen(path, "r");
+	char line[MAX_LINE];
+	char *text = 0;
+	uint32_t ms = 0;
+	int offset = 0;
+	size_t len = 0;
+
+	if(!file) {
+		perror(path);
+		return 1;
+	}
+	while(fgets(line, sizeof(line), file)) {
+		if((line[0] == '#') || (line[0] == '\n')) {
+			continue;
+		}
+		if(sscanf(line, "%u %n", &ms, &offset) != 1) {
+			fprintf(stderr, "%s: bad line %s", path, line);
+			fclose(file);
+			return 1;
+		}
+		/* the newline of the file is sent too */
+		len = strlen(&line[offset]);
+		if(!len || (line[offset + len - 1] != '\n')) {
+			strcat(line, "\n");
+			len++;
+		}
+		if(len > UART_INPUT_MAX) {
+			fprintf(stderr, "%s: line longer than %d bytes\n", path, UART_INPUT_MAX);
+			fclose(file);
+			return 1;
+		}
+		text = strdup(&line[offset]);
+		if(!text || event_add(ms, text, 0, 0)) {
+			fclose(file);
+			return 1;
+		}
+	}
+	fclose(file);
+
+	return 0;
+}
+
+static int event_compare(const void *a, const void *b) {
+
+	const struct event *x = a;
+	const struct event *y = b;
+
+	return (x->cycle > y->cycle) - (x->cycle < y->cycle);
+}
+
+static void event_run(const struct event *event) {
+
+	avr_irq_t *uart_input = 0;
+	const char *c = 0;
+
+	if(event->text) {
+		uart_input = avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_INPUT);
+		for(c = event->text; *c; c++) {
+			avr_raise_irq(uart_input, (uint8_t)*c);
+		}
+	} else {
+		avr_raise_irq(pin_irq(event->pin), event->level);
+	}
+}
+
+/* every byte the firmware sends */
+static void uart_output(struct avr_irq_t *irq, uint32_t value, void *param) {
+	if(output_len < MAX_OUTPUT) {
+		output_cycle[output_len] = avr->cycle;
+		output[output_len++] = (uint8_t)value;
+	}
+}
+
+/* reads hex bytes or the raw file */
+static long golden_read(const char *path, uint8_t *golden) {
+
+	FILE *file = fopen(path, "r");
+	size_t len = strlen(path);
+	char token[MAX_LINE];
+	long count = 0;
+	int c = 0;
+
+	if(!file) {
+		perror(path);
+		return -1;
+	}
+
+	if((len > 4) && !strcmp(&path[len - 4], ".hex")) {
+		while(fscanf(file, "%255s", token) == 1) {
+			if(token[0] == '#') {
+				/* comment up to the end of the line */
+				while(((c = fgetc(file)) != EOF) && (c != '\n')) {
+				}
+				continue;
+			}
+			if((count >= MAX_GOLDEN) || !isxdigit((unsigned char)token[0])) {
+				fprintf(stderr, "%s: bad byte %s\n", path, token);
+				fclose(file);
+				return -1;
+			}
+			golden[count++] = (uint8_t)strtoul(token, 0, 16);
+		}
+	} else {
+		count = (long)fread(golden, 1, MAX_GOLDEN, file);
+	}
+	fclose(file);
+
+	return count;
+}
+
+static double cycles_to_ms(uint64_t cycles) {
+	return cycles * 1000.0 / avr->frequency;
+}
+
+/* compares the output, prefix only compares the length of the golden
+ * file, deadline 0 means none */
+static int golden_check(const char *path, uint8_t prefix, uint32_t deadline_ms) {
+
+	static uint8_t golden[MAX_GOLDEN];
+	long len = golden_read(path, golden);
+	long i = 0;
+	double done_ms = 0;
+
+	if(len < 0) {
+		return 1;
+	}
+
+	for(i = 0; (i < len) && (i < (long)output_len); i++) {
+		if(output[i] != golden[i]) {
+			printf("uart: byte %ld is 0x%02x, expected 0x%02x (%s)\n", i, output[i], golden[i], path);
+			return 1;
+		}
+	}
+	if((long)output_len < len) {
+		printf("uart: %u bytes, expected %ld (%s)\n", output_len, len, path);
+		return 1;
+	}
+	if(!prefix && ((long)output_len > len)) {
+		printf("uart: %u bytes, expected only %ld (%s)\n", output_len, len, path);
+		return 1;
+	}
+
+	if(len) {
+		done_ms = cycles_to_ms(output_cycle[len - 1]);
+		printf("uart: expected output complete at %.3f ms\n", done_ms);
+		if(deadline_ms && (done_ms > deadline_ms)) {
+			printf("uart: expected output complete after the deadline of %u ms\n", deadline_ms);
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+/* finds the avg column of a benchmark row, name,iterations,min,avg,max */
+static int csv_average(const char *text, const char *name, unsigned long *average) {
+
+	char row[MAX_LINE];
+	const char *line = text;
+	size_t len = strlen(name);
+	unsigned long iterations = 0;
+	unsigned long min = 0;
+
+	while(line && *line) {
+		if(!strncmp(line, name, len) && (line[len] == ',')) {
+			strncpy(row, &line[len + 1], sizeof(row) - 1);
+			row[sizeof(row) - 1] = '\0';
+			return sscanf(row, "%lu,%lu,%lu", &iterations, &min, average) != 3;
+		}
+		line = strchr(line, '\n');
+		if(line) {
+			line++;
+		}
+	}
+	return 1;
+}
+
+/* every row of the baseline must be in the output and not slower */
+static int baseline_check(const char *arg) {
+
+	static char baseline[MAX_GOLDEN + 1];
+	static char text[MAX_OUTPUT + 1];
+	char path[MAX_LINE];
+	char name[MAX_LINE];
+	unsigned percent = 0;
+	unsigned long base = 0;
+	unsigned long average = 0;
+	const char *line = baseline;
+	long len = 0;
+	int failures = 0;
+
+	if(sscanf(arg, "%255[^:]:%u", path, &percent) != 2) {
+		fprintf(stderr, "bad baseline %s\n", arg);
+		return 1;
+	}
+	len = golden_read(path, (uint8_t *)baseline);
+	if(len < 0) {
+		return 1;
+	}
+	baseline[len] = '\0';
+	memcpy(text, output, output_len);
+	text[output_len] = '\0';
+
+	while(line && *line) {
+		/* the header has no numbers and is skipped */
+		if((sscanf(line, "%255[^,],%*u,%*u,%lu", name, &base) == 2)) {
+			if(csv_average(text, name, &average)) {
+				printf("benchmark: %s missing in the output\n", name);
+				failures++;
+			} else if(average * 100 > base * (100 + percent)) {
+				printf("benchmark: %s takes %lu cycles, baseline %lu + %u %%\n", name, average, base, percent);
+				failures++;
+			}
+		}
+		line = strchr(line, '\n');
+		if(line) {
+			line++;
+		}
+	}
+
+	return failures;
+}
+
+/* the checks on the pins, from the VCD file */
+static int pin_checks(const char *path) {
+
+	struct vcd_file vcd;
+	const struct vcd_signal *signal = 0;
+	int failures = 0;
+	int i = 0;
+	uint32_t value = 0;
+
+	if(vcd_read(path, &vcd)) {
+		printf("%s: can not be read\n", path);
+		return 1;
+	}
+
+	for(i = 0; i < check_count; i++) {
+		signal = vcd_find(&vcd, checks[i].pin);
+		if(!signal) {
+			printf("%s: no changes in %s\n", checks[i].pin, path);
+			failures++;
+			continue;
+		}
+		switch(checks[i].type) {
+			case CHECK_PERIOD:
+				failures += vcd_check_period(signal, checks[i].min, checks[i].max, checks[i].count, stdout);
+				break;
+			case CHECK_WIDTH:
+				failures += vcd_check_width(signal, checks[i].min, checks[i].max, checks[i].count, stdout);
+				break;
+			case CHECK_EDGES:
+				value = vcd_edges(signal);
+				if(value < checks[i].count) {
+					printf("%s: %u edges, expected at least %u\n", signal->name, value, checks[i].count);
+					failures++;
+				}
+				break;
+			case CHECK_LEVEL:
+				value = vcd_level(signal);
+				if(value != checks[i].count) {
+					printf("%s: level %d at the end, expected %u\n", signal->name,
+							(value == VCD_UNKNOWN) ? -1 : (int)value, checks[i].count);
+					failures++;
+				}
+				break;
+		}
+	}
+	vcd_free(&vcd);
+
+	return failures;
+}
+
+/*********************************************************************
+ * MAIN FUNCTION
+ *********************************************************************/
+int main(int argc, char *argv[]) {
+
+	elf_firmware_t firmware;
+	struct sim_mpu6050 mpu;
+	avr_vcd_t vcd;
+	const char *vcd_path = "sim_test.vcd";
+	const char *golden_path = 0;
+	const char *output_path = 0;
+	const char *baseline = 0;
+	uint8_t golden_prefix = 0;
+	uint8_t use_mpu = 0;
+	uint32_t limit_ms = 1000;
+	uint32_t deadline_ms = 0;
+	uint64_t limit = 0;
+	int state = cpu_Running;
+	int next = 0;
+	int failures = 0;
+	int opt = 0;
+	int i = 0;
+	int j = 0;
+	FILE *file = 0;
+
+	while((opt = getopt(argc, argv, "t:mi:g:G:d:o:b:v:p:w:e:l:s:c:")) != -1) {
+		switch(opt) {
+			case 't': limit_ms = strtoul(optarg, 0, 10); break;
+			case 'm': use_mpu = 1; break;
+			case 'i': if(input_read(optarg)) return 2; break;
+			case 'g': golden_path = optarg; golden_prefix = 0; break;
+			case 'G': golden_path = optarg; golden_prefix = 1; break;
+			case 'd': deadline_ms = strtoul(optarg, 0, 10); break;
+			case 'o': output_path = optarg; break;
+			case 'b': baseline = optarg; break;
+			case 'v': vcd_path = optarg; break;
+			case 'p': if(check_parse(CHECK_PERIOD, optarg)) return 2; break;
+			case 'w': if(check_parse(CHECK_WIDTH, optarg)) return 2; break;
+			case 'e': if(check_parse(CHECK_EDGES, optarg)) return 2; break;
+			case 'l': if(check_parse(CHECK_LEVEL, optarg)) return 2; break;
+			case 's': if(stimulus_parse(optarg)) return 2; break;
+			case 'c': if(wire_parse(optarg)) return 2; break;
+			default: usage(argv[0]); return 2;
+		}
+	}
+	if(optind != (argc - 1)) {
+		usage(argv[0]);
+		return 2;
+	}
+
+	/* the .mmcu section of the demo selects MCU and clock */
+	memset(&firmware, 0, sizeof(firmware));
+	if(elf_read_firmware(argv[optind], &firmware)) {
+		fprintf(stderr, "%s: can not be loaded\n", argv[optind]);
+		return 2;
+	}
+	avr = avr_make_mcu_by_name(firmware.mmcu[0] ? firmware.mmcu : "atmega328p");
+	if(!avr) {
+		fprintf(stderr, "%s: unknown MCU %s\n", argv[optind], firmware.mmcu);
+		return 2;
+	}
+	avr_init(avr);
+	avr_load_firmware(avr, &firmware);
+	if(!avr->frequency) {
+		avr->frequency = DEFAULT_FREQUENCY;
+	}
+
+	/* the UART output goes to the checks instead of the console */
+	{
+		uint32_t flags = 0;
+		avr_ioctl(avr, AVR_IOCTL_UART_GET_FLAGS('0'), &flags);
+		flags &= ~AVR_UART_FLAG_STDIO;
+		avr_ioctl(avr, AVR_IOCTL_UART_SET_FLAGS('0'), &flags);
+	}
+	avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('0'), UART_IRQ_OUTPUT),
+			uart_output, 0);
+
+	if(use_mpu) {
+		sim_mpu6050_attach(&mpu, avr);
+	}
+	for(i = 0; i < wire_count; i++) {
+		avr_connect_irq(pin_irq(wires[i][0]), pin_irq(wires[i][1]));
+	}
+
+	/* one VCD signal per checked pin */
+	if(check_count) {
+		avr_vcd_init(avr, vcd_path, &vcd, 1000);
+		for(i = 0; i < check_count; i++) {
+			for(j = 0; (j < i) && strcmp(checks[j].pin, checks[i].pin); j++) {
+			}
+			if(j == i) {
+				avr_vcd_add_signal(&vcd, pin_irq(checks[i].pin), 1, checks[i].pin);
+			}
+		}
+		avr_vcd_start(&vcd);
+	}
+
+	/* the input events in cycles, in order */
+	for(i = 0; i < event_count; i++) {
+		events[i].cycle = avr_usec_to_cycles(avr, events[i].cycle * 1000);
+	}
+	qsort(events, event_count, sizeof(events[0]), event_compare);
+
+	limit = avr_usec_to_cycles(avr, (uint64_t)limit_ms * 1000);
+	while(avr->cycle < limit) {
+		while((next < event_count) && (avr->cycle >= events[next].cycle)) {
+			event_run(&events[next++]);
+		}
+		state = avr_run(avr);
+		if((state == cpu_Done) || (state == cpu_Crashed)) {
+			break;
+		}
+	}
+
+	if(check_count) {
+		avr_vcd_close(&vcd);
+	}
+
+	printf("%s: %s after %.3f ms (%llu cycles at %u Hz)\n", argv[optind],
+			(state == cpu_Crashed) ? "crashed" : (state == cpu_Done) ? "stopped" : "time limit",
+			cycles_to_ms(avr->cycle), (unsigned long long)avr->cycle, (unsigned)avr->frequency);
+	if(output_len) {
+		printf("uart: %u bytes from %.3f ms to %.3f ms\n", output_len,
+				cycles_to_ms(output_cycle[0]), cycles_to_ms(output_cycle[output_len - 1]));
+	}
+	if(use_mpu) {
+		printf("mpu6050: %u transactions, %u bytes, PWR_MGMT_1 0x%02x\n",
+				mpu.transactions, mpu.bytes, mpu.regs[0x6b]);
+	}
+
+	if(state == cpu_Crashed) {
+		failures++;
+	}
+	if(output_path) {
+		file = fopen(output_path, "wb");
+		if(!file || (fwrite(output, 1, output_len, file) != output_len)) {
+			perror(output_path);
+			failures++;
+		}
+		if(file) {
+			fclose(file);
+		}
+	}
+	if(golden_path) {
+		failures += golden_check(golden_path, golden_prefix, deadline_ms);
+	}
+	if(baseline) {
+		failures += baseline_check(baseline);
+	}
+	if(check_count) {
+		failures += pin_checks(vcd_path);
+	}
+
+	avr_terminate(avr);
+
+	printf("%s: %s\n", argv[optind], failures ? "FAIL" : "PASS");
+
+	return failures ? 1 : 0;
+}
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
@@ -0,0 +1,359 @@
+/*********************************************************************
+ * Simulation Test - VCD Reader - C File
+ * Short Name: sim_vcd
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: reads the value changes of a VCD file and checks the
+ *							timing of pin signals
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim_vcd.h"
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+/* longest token, vectors of 32 bit plus the b */
+#define VCD_TOKEN_SIZE 64
+
+/*********************************************************************
+ * LOCAL FUNCTIONS
+ *********************************************************************/
+/* reads the next whitespace separated token, 0 at the end of the
+ * file */
+static int vcd_token(FILE *file, char *token) {
+	return fscanf(file, "%63s", token) == 1;
+}
+
+/* skips everything up to and including the next $end */
+static void vcd_skip(FILE *file) {
+
+	char token[VCD_TOKEN_SIZE];
+
+	while(vcd_token(file, token) && strcmp(token, "$end")) {
+	}
+}
+
+/* converts the unit of $timescale, e.g. "1ns" or "1 ns", to a factor
+ * for ns, sub ns units become a divider */
+static int vcd_timescale(FILE *file, uint64_t *mul, uint64_t *div) {
+
+	char token[VCD_TOKEN_SIZE];
+	char text[2 * VCD_TOKEN_SIZE] = "";
+	char *unit = 0;
+	uint64_t number = 0;
+
+	while(vcd_token(file, token) && strcmp(token, "$end")) {
+		strncat(text, token, VCD_TOKEN_SIZE - 1);
+	}
+	number = strtoull(text, &unit, 10);
+	if(number == 0) {
+		return 1;
+	}
+
+	*div = 1;
+	if(!strcmp(unit, "s")) {
+		*mul = number * 1000000000ULL;
+	} else if(!strcmp(unit, "ms")) {
+		*mul = number * 1000000ULL;
+	} else if(!strcmp(unit, "us")) {
+		*mul = number * 1000ULL;
+	} else if(!strcmp(unit, "ns")) {
+		*mul = number;
+	} else if(!strcmp(unit, "ps")) {
+		*mul = number;
+		*div = 1000;
+	} else {
+		return 1;
+	}
+
+	return 0;
+}
+
+/* adds a $var, the name may be followed by a bit range */
+static int vcd_var(FILE *file, struct vcd_file *vcd) {
+
+	char type[VCD_TOKEN_SIZE];
+	char width[VCD_TOKEN_SIZE];
+	char id[VCD_TOKEN_SIZE];
+	char name[VCD_TOKEN_SIZE];
+	struct vcd_signal *signal = 0;
+
+	if(!vcd_token(file, type) || !vcd_token(file, width) ||
+		 !vcd_token(file, id) || !vcd_token(file, name)) {
+		return 1;
+	}
+	vcd_skip(file);
+
+	if(vcd->count >= VCD_MAX_SIGNALS) {
+		return 1;
+	}
+	signal = &vcd->signals[vcd->count++];
+	memset(signal, 0, sizeof(*signal));
+	strncpy(signal->name, name, VCD_NAME_SIZE - 1);
+	strncpy(signal->id, id, VCD_ID_SIZE - 1);
+	signal->width = (uint8_t)atoi(width);
+
+	return 0;
+}
+
+static struct vcd_signal *vcd_find_id(struct vcd_file *vcd, const char *id) {
+
+	uint8_t i = 0;
+
+	for(i = 0; i < vcd->count; i++) {
+		if(!strcmp(vcd->signals[i].id, id)) {
+			return &vcd->signals[i];
+		}
+	}
+	return 0;
+}
+
+/* appends a change, a value equal to the last one is dropped */
+static int vcd_change(struct vcd_signal *signal, uint64_t time_ns, uint32_t value) {
+
+	struct vcd_change *changes = 0;
+
+	if(signal->count && (signal->changes[signal->count - 1].value == value)) {
+		return 0;
+	}
+	if(signal->count == signal->size) {
+		signal->size = signal->size ? (signal->size * 2) : 256;
+		changes = realloc(signal->changes, signal->size * sizeof(*changes));
+		if(!changes) {
+			return 1;
+		}
+		signal->changes = changes;
+	}
+	signal->changes[signal->count].time_ns = time_ns;
+	signal->changes[signal->count].value = value;
+	signal->count++;
+
+	return 0;
+}
+
+/* value of a scalar or vector change, x and z in any bit make the
+ * whole value unknown */
+static uint32_t vcd_value(const char *bits) {
+
+	uint32_t value = 0;
+
+	for(; *bits; bits++) {
+		if((*bits != '0') && (*bits != '1')) {
+			return VCD_UNKNOWN;
+		}
+		value = (value << 1) | (uint32_t)(*bits - '0');
+	}
+	return value;
+}
+
+/* finds the next rising edge of bit 0 from index on, returns the
+ * index of the change or the number of changes */
+static uint32_t vcd_next_edge(const struct vcd_signal *signal, uint32_t index, uint8_t rising) {
+
+	uint32_t before = 0;
+	uint32_t after = 0;
+
+	for(; index < signal->count; index++) {
+		if(index == 0) {
+			continue;
+		}
+		before = signal->changes[index - 1].value;
+		after = signal->changes[index].value;
+		if((before == VCD_UNKNOWN) || (after == VCD_UNKNOWN)) {
+			continue;
+		}
+		if(((before & 1) != rising) && ((after & 1) == rising)) {
+			return index;
+		}
+	}
+	return signal->count;
+}
+
+/*********************************************************************
+ * FUNCTIONS
+ *********************************************************************/
+int vcd_read(const char *path, struct vcd_file *vcd) {
+
+	FILE *file = fopen(path, "r");
+	char token[VCD_TOKEN_SIZE];
+	char id[VCD_TOKEN_SIZE];
+	uint64_t mul = 1;
+	uint64_t div = 1;
+	uint64_t time_ns = 0;
+	struct vcd_signal *signal = 0;
+	int error = 0;
+
+	memset(vcd, 0, sizeof(*vcd));
+	if(!file) {
+		return 1;
+	}
+
+	while(!error && vcd_token(file, token)) {
+
+		if(!strcmp(token, "$timescale")) {
+			error = vcd_timescale(file, &mul, &div);
+		} else if(!strcmp(token, "$var")) {
+			error = vcd_var(file, vcd);
+		} else if(!strcmp(token, "$dumpvars") || !strcmp(token, "$dumpall") ||
+							!strcmp(token, "$dumpon") || !strcmp(token, "$dumpoff") ||
+							!strcmp(token, "$end")) {
+			/* the changes inside are normal changes */
+		} else if(token[0] == '$') {
+			/* $date, $version, $scope, $enddefinitions, ... */
+			vcd_skip(file);
+		} else if(token[0] == '#') {
+			time_ns = strtoull(&token[1], 0, 10) * mul / div;
+			vcd->end_ns = time_ns;
+		} else if((token[0] == 'b') || (token[0] == 'B')) {
+			if(!vcd_token(file, id)) {
+				error = 1;
+			} else if((signal = vcd_find_id(vcd, id))) {
+				error = vcd_change(signal, time_ns, vcd_value(&token[1]));
+			}
+		} else if((token[0] == 'r') || (token[0] == 'R')) {
+			/* reals are not used by simavr, skip the id */
+			error = !vcd_token(file, id);
+		} else if(strchr("01xXzZ", token[0])) {
+			if((signal = vcd_find_id(vcd, &token[1]))) {
+				id[0] = token[0];
+				id[1] = '\0';
+				error = vcd_change(signal, time_ns, vcd_value(id));
+			}
+		} else {
+			error = 1;
+		}
+	}
+
+	fclose(file);
+	if(error) {
+		vcd_free(vcd);
+	}
+
+	return error;
+}
+
+void vcd_free(struct vcd_file *vcd) {
+
+	uint8_t i = 0;
+
+	for(i = 0; i < vcd->count; i++) {
+		free(vcd->signals[i].changes);
+		vcd->signals[i].changes = 0;
+		vcd->signals[i].count = 0;
+		vcd->signals[i].size = 0;
+	}
+}
+
+const struct vcd_signal *vcd_find(const struct vcd_file *vcd, const char *name) {
+
+	uint8_t i = 0;
+
+	for(i = 0; i < vcd->count; i++) {
+		if(!strcmp(vcd->signals[i].name, name)) {
+			return &vcd->signals[i];
+		}
+	}
+	return 0;
+}
+
+uint32_t vcd_edges(const struct vcd_signal *signal) {
+
+	uint32_t edges = 0;
+	uint32_t i = 0;
+
+	for(i = 1; i < signal->count; i++) {
+		if((signal->changes[i - 1].value != VCD_UNKNOWN) &&
+			 (signal->changes[i].value != VCD_UNKNOWN) &&
+			 ((signal->changes[i - 1].value ^ signal->changes[i].value) & 1)) {
+			edges++;
+		}
+	}
+	return edges;
+}
+
+uint32_t vcd_level(const struct vcd_signal *signal) {
+	return signal->count ? signal->changes[signal->count - 1].value : VCD_UNKNOWN;
+}
+
+int vcd_check_period(const struct vcd_signal *signal, uint32_t min_us, uint32_t max_us,
+		uint32_t count, FILE *report) {
+
+	uint32_t rise = vcd_next_edge(signal, 0, 1);
+	uint32_t next = 0;
+	uint32_t periods = 0;
+	uint64_t period_ns = 0;
+	int failures = 0;
+
+	while(rise < signal->count) {
+		next = vcd_next_edge(signal, rise + 1, 1);
+		if(next >= signal->count) {
+			break;
+		}
+		period_ns = signal->changes[next].time_ns - signal->changes[rise].time_ns;
+		if((period_ns < (uint64_t)min_us * 1000) || (period_ns > (uint64_t)max_us * 1000)) {
+			fprintf(report, "%s: period of %.3f us at %.3f ms, expected [%u - %u] us\n",
+					signal->name, period_ns / 1000.0, signal->changes[rise].time_ns / 1e6,
+					min_us, max_us);
+			failures++;
+		}
+		periods++;
+		rise = next;
+	}
+
+	if(periods < count) {
+		fprintf(report, "%s: %u periods, expected at least %u\n", signal->name, periods, count);
+		failures++;
+	}
+
+	return failures;
+}
+
+int vcd_check_width(const struct vcd_signal *signal, uint32_t min_us, uint32_t max_us,
+		uint32_t count, FILE *report) {
+
+	uint32_t rise = vcd_next_edge(signal, 0, 1);
+	uint32_t fall = 0;
+	uint32_t pulses = 0;
+	uint64_t width_ns = 0;
+	int failures = 0;
+
+	while(rise < signal->count) {
+		fall = vcd_next_edge(signal, rise + 1, 0);
+		if(fall >= signal->count) {
+			/* still high at the end of the file */
+			break;
+		}
+		width_ns = signal->changes[fall].time_ns - signal->changes[rise].time_ns;
+		if((width_ns < (uint64_t)min_us * 1000) || (width_ns > (uint64_t)max_us * 1000)) {
+			fprintf(report, "%s: pulse of %.3f us at %.3f ms, expected [%u - %u] us\n",
+					signal->name, width_ns / 1000.0, signal->changes[rise].time_ns / 1e6,
+					min_us, max_us);
+			failures++;
+		}
+		pulses++;
+		rise = vcd_next_edge(signal, fall + 1, 1);
+	}
+
+	if(pulses < count) {
+		fprintf(report, "%s: %u pulses, expected at least %u\n", signal->name, pulses, count);
+		failures++;
+	}
+
+	return failures;
+}
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
@@ -0,0 +1,141 @@
+/*********************************************************************
+ * Simulation Test - VCD Reader - Header File
+ * Short Name: sim_vcd
+ * Author: nmt @ NT-COM
+ * Date: 17.10.2026
+ * Description: reads the value changes of a VCD file and checks the
+ *							timing of pin signals
+ *********************************************************************/
+
+/*********************************************************************
+ * Changelog:
+ * [Date][Author]:[Change]
+ * [17.10.2026][nmt]: initial commit
+ *********************************************************************/
+
+/*********************************************************************
+ * NOTES:	Only what simavr writes is supported: one scope, wires of
+ *				1 to 32 bit, scalar changes like "1!" and vector changes
+ *				like "b1010 !". x and z are kept as VCD_UNKNOWN, a change
+ *				to or from them is not an edge. All times are converted to
+ *				ns with the $timescale of the file.
+ *
+ *				The checks print one line per failure to the report and
+ *				return the number of failures.
+ *********************************************************************/
+
+#ifndef SIM_VCD_H
+#define SIM_VCD_H
+
+/*********************************************************************
+ * LIBRARIES
+ *********************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+
+/*********************************************************************
+ * MACROS
+ *********************************************************************/
+#define VCD_MAX_SIGNALS 32
+#define VCD_NAME_SIZE 32
+#define VCD_ID_SIZE 8
+
+/* value of a signal that is x or z */
+#define VCD_UNKNOWN 0xffffffffUL
+
+/*********************************************************************
+ * TYPES
+ *********************************************************************/
+/* a value change */
+struct vcd_change {
+	uint64_t time_ns;
+	uint32_t value;
+};
+
+/* all changes of one signal, in the order of the file */
+struct vcd_signal {
+	char name[VCD_NAME_SIZE];
+	char id[VCD_ID_SIZE];
+	uint8_t width;
+	struct vcd_change *changes;
+	uint32_t count;
+	uint32_t size;
+};
+
+struct vcd_file {
+	struct vcd_signal signals[VCD_MAX_SIGNALS];
+	uint8_t count;
+	/* time of the last timestamp in the file */
+	uint64_t end_ns;
+};
+
+/*********************************************************************
+ * FUNCTION PROTOTYPES
+ *********************************************************************/
+
+/**
+ * @brief reads a VCD file
+ * @param path the file
+ * @param vcd filled with the signals, free it with vcd_free
+ * @return 0 on success, 1 if the file can not be read or parsed
+ */
+int vcd_read(const char *path, struct vcd_file *vcd);
+
+/**
+ * @brief frees the changes of all signals
+ * @param vcd a file read by vcd_read
+ * @return void
+ */
+void vcd_free(struct vcd_file *vcd);
+
+/**
+ * @brief looks up a signal by the name of its $var
+ * @param vcd the file
+ * @param name e.g. "PB3"
+ * @return the signal, NULL if there is none
+ */
+const struct vcd_signal *vcd_find(const struct vcd_file *vcd, const char *name);
+
+/**
+ * @brief counts the changes between 0 and 1 of bit 0
+ * @param signal the signal
+ * @return number of rising and falling edges
+ */
+uint32_t vcd_edges(const struct vcd_signal *signal);
+
+/**
+ * @brief value at the end of the file
+ * @param signal the signal
+ * @return the value, VCD_UNKNOWN if it never had one
+ */
+uint32_t vcd_level(const struct vcd_signal *signal);
+
+/**
+ * @brief checks the time between consecutive rising edges of bit 0
+ * @param signal the signal
+ * @param min_us shortest allowed period
+ * @param max_us longest allowed period
+ * @param count least number of periods
+ * @param report failures are printed here
+ * @return number of failures
+ */
+int vcd_check_period(const struct vcd_signal *signal, uint32_t min_us, uint32_t max_us,
+		uint32_t count, FILE *report);
+
+/**
+ * @brief checks the time from each rising edge of bit 0 to the next
+ * falling edge
+ * @param signal the signal
+ * @param min_us shortest allowed high time
+ * @param max_us longest allowed high time
+ * @param count least number of pulses
+ * @param report failures are printed here
+ * @return number of failures
+ */
+int vcd_check_width(const struct vcd_signal *signal, uint32_t min_us, uint32_t max_us,
+		uint32_t count, FILE *report);
+
+/*********************************************************************
+ * EOF
+ *********************************************************************/
+#endif